@@ -0,0 +1,166 @@
+// Copyright (c) 2015-2017 The Bitcoin Core developers
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "clientversion.h"
+
+#include <univalue.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <regex>
+
+namespace {
+
+struct Summary {
+    double total;
+    double min;
+    double max;
+    double median;
+};
+
+Summary Summarize(const benchmark::State& state)
+{
+    assert(!state.m_elapsed_results.empty());
+    std::vector<double> results = state.m_elapsed_results;
+    std::sort(results.begin(), results.end());
+
+    Summary s;
+    s.total = state.m_num_iters * std::accumulate(results.begin(), results.end(), 0.0);
+    s.min = results.front();
+    s.max = results.back();
+    const size_t mid = results.size() / 2;
+    s.median = results.size() % 2 ? results[mid] : (results[mid - 1] + results[mid]) / 2;
+    return s;
+}
+
+} // namespace
+
+void benchmark::ConsolePrinter::header()
+{
+    std::cout << "# Benchmark, evals, iterations, total, min, max, median" << std::endl;
+}
+
+void benchmark::ConsolePrinter::result(const State& state)
+{
+    if (state.m_elapsed_results.empty()) {
+        std::cout << state.m_name << ", skipped" << std::endl;
+        return;
+    }
+    const Summary s = Summarize(state);
+    std::cout << std::setprecision(6);
+    std::cout << state.m_name << ", " << state.m_num_evals << ", " << state.m_num_iters << ", "
+              << s.total << ", " << s.min << ", " << s.max << ", " << s.median << std::endl;
+}
+
+void benchmark::ConsolePrinter::footer() {}
+
+void benchmark::CsvPrinter::header()
+{
+    std::cout << "name,evals,iterations,total_s,min_s,max_s,median_s" << std::endl;
+}
+
+void benchmark::CsvPrinter::result(const State& state)
+{
+    if (state.m_elapsed_results.empty()) return;
+    const Summary s = Summarize(state);
+    std::cout << std::setprecision(9);
+    std::cout << state.m_name << "," << state.m_num_evals << "," << state.m_num_iters << ","
+              << s.total << "," << s.min << "," << s.max << "," << s.median << std::endl;
+}
+
+void benchmark::CsvPrinter::footer() {}
+
+void benchmark::JsonPrinter::header()
+{
+    std::cout << "{\"version\":" << UniValue(FormatFullVersion()).write() << ",\"benchmarks\":[" << std::endl;
+}
+
+void benchmark::JsonPrinter::result(const State& state)
+{
+    if (state.m_elapsed_results.empty()) return;
+    const Summary s = Summarize(state);
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("name", state.m_name);
+    obj.pushKV("evals", state.m_num_evals);
+    obj.pushKV("iterations", state.m_num_iters);
+    obj.pushKV("total_s", s.total);
+    obj.pushKV("min_s", s.min);
+    obj.pushKV("max_s", s.max);
+    obj.pushKV("median_s", s.median);
+    // Printed as each benchmark completes, so a partial run is still useful
+    std::cout << (m_first ? "" : ",\n") << obj.write();
+    m_first = false;
+}
+
+void benchmark::JsonPrinter::footer()
+{
+    std::cout << "\n]}" << std::endl;
+}
+
+benchmark::BenchRunner::BenchmarkMap& benchmark::BenchRunner::benchmarks()
+{
+    static std::map<std::string, Bench> benchmarks_map;
+    return benchmarks_map;
+}
+
+benchmark::BenchRunner::BenchRunner(std::string name, benchmark::BenchFunction func, uint64_t num_iters_for_one_second)
+{
+    benchmarks().insert(std::make_pair(name, Bench{func, num_iters_for_one_second}));
+}
+
+void benchmark::BenchRunner::RunAll(Printer& printer, uint64_t num_evals, double scaling, const std::string& filter, bool is_list_only)
+{
+    if (!std::ratio_less_equal<benchmark::clock::period, std::micro>::value) {
+        std::cerr << "WARNING: Clock precision is worse than microsecond - benchmarks may be less accurate!\n";
+    }
+
+    std::regex reFilter(filter);
+    std::smatch baseMatch;
+
+    if (is_list_only) {
+        for (const auto& p : benchmarks()) {
+            if (std::regex_match(p.first, baseMatch, reFilter)) {
+                std::cout << p.first << std::endl;
+            }
+        }
+        return;
+    }
+
+    printer.header();
+    for (const auto& p : benchmarks()) {
+        if (!std::regex_match(p.first, baseMatch, reFilter)) {
+            continue;
+        }
+
+        uint64_t num_iters = static_cast<uint64_t>(p.second.num_iters_for_one_second * scaling);
+        if (0 == num_iters) {
+            num_iters = 1;
+        }
+        State state(p.first, num_evals, num_iters);
+        p.second.func(state);
+        printer.result(state);
+    }
+    printer.footer();
+}
+
+bool benchmark::State::UpdateTimer(const benchmark::time_point current_time)
+{
+    if (m_start_time != time_point()) {
+        std::chrono::duration<double> diff = current_time - m_start_time;
+        m_elapsed_results.push_back(diff.count() / m_num_iters);
+
+        if (m_elapsed_results.size() == m_num_evals) {
+            return false;
+        }
+    }
+
+    m_num_iters_left = m_num_iters - 1;
+    return true;
+}
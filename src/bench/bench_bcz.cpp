@@ -0,0 +1,82 @@
+// Copyright (c) 2015-2017 The Bitcoin Core developers
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "bls/bls_wrapper.h"
+#include "chainparams.h"
+#include "key.h"
+#include "random.h"
+#include "script/sigcache.h"
+#include "util/system.h"
+#include "utilstrencodings.h"
+
+#include <iostream>
+#include <memory>
+
+static const int64_t DEFAULT_BENCH_EVALUATIONS = 5;
+static const char* DEFAULT_BENCH_FILTER = ".*";
+static const char* DEFAULT_BENCH_SCALING = "1.0";
+static const char* DEFAULT_BENCH_PRINTER = "console";
+
+int main(int argc, char** argv)
+{
+    gArgs.ParseParameters(argc, argv);
+
+    if (gArgs.IsArgSet("-?") || gArgs.IsArgSet("-h") || gArgs.IsArgSet("-help")) {
+        std::cout << "Usage:  bench_bcz [options]\n\n"
+                  << "Options:\n"
+                  << "  -?                    Print this help message and exit\n"
+                  << "  -list                 List benchmarks without executing them\n"
+                  << strprintf("  -evals=<n>            Number of measurement evaluations to perform (default: %u)\n", DEFAULT_BENCH_EVALUATIONS)
+                  << strprintf("  -filter=<regex>       Regular expression filter to select benchmark by name (default: %s)\n", DEFAULT_BENCH_FILTER)
+                  << strprintf("  -scaling=<n>          Scaling factor for benchmark's runtime (default: %s)\n", DEFAULT_BENCH_SCALING)
+                  << strprintf("  -printer=<format>     Output format: console, csv or json (default: %s)\n", DEFAULT_BENCH_PRINTER);
+        return 0;
+    }
+
+    RandomInit();
+    ECC_Start();
+    ECCVerifyHandle verifyHandle;
+    if (!BLSInit()) {
+        std::cerr << "BLS initialization failed" << std::endl;
+        return 1;
+    }
+    SetupEnvironment();
+    SelectParams(CBaseChainParams::REGTEST);
+    InitSignatureCache();
+
+    int64_t evaluations = gArgs.GetArg("-evals", DEFAULT_BENCH_EVALUATIONS);
+    std::string regex_filter = gArgs.GetArg("-filter", DEFAULT_BENCH_FILTER);
+    std::string scaling_str = gArgs.GetArg("-scaling", DEFAULT_BENCH_SCALING);
+    std::string printer_arg = gArgs.GetArg("-printer", DEFAULT_BENCH_PRINTER);
+    bool is_list_only = gArgs.GetBoolArg("-list", false);
+
+    double scaling_factor;
+    if (!ParseDouble(scaling_str, &scaling_factor)) {
+        std::cerr << strprintf("Error parsing scaling factor as double: %s\n", scaling_str);
+        return 1;
+    }
+    if (evaluations < 1) {
+        std::cerr << strprintf("Error: -evals must be at least 1\n");
+        return 1;
+    }
+
+    std::unique_ptr<benchmark::Printer> printer;
+    if (printer_arg == "console") {
+        printer.reset(new benchmark::ConsolePrinter());
+    } else if (printer_arg == "csv") {
+        printer.reset(new benchmark::CsvPrinter());
+    } else if (printer_arg == "json") {
+        printer.reset(new benchmark::JsonPrinter());
+    } else {
+        std::cerr << strprintf("Error: unknown printer '%s' (expected console, csv or json)\n", printer_arg);
+        return 1;
+    }
+
+    benchmark::BenchRunner::RunAll(*printer, evaluations, scaling_factor, regex_filter, is_list_only);
+
+    ECC_Stop();
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2016-2017 The Bitcoin Core developers
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "coins.h"
+#include "random.h"
+#include "script/standard.h"
+
+static const int CACHE_BENCH_COINS = 1000;
+
+static std::vector<COutPoint> RandomOutpoints(int nCount)
+{
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(nCount);
+    for (int i = 0; i < nCount; i++) {
+        outpoints.emplace_back(GetRandHash(), i % 3);
+    }
+    return outpoints;
+}
+
+// The block connection pattern: a throwaway view on top of the coins tip,
+// spending coins fetched from the tip and adding the new outputs.
+static void CCoinsCaching_SpendAdd(benchmark::State& state)
+{
+    const CTxOut out(COIN, GetScriptForDestination(CKeyID()));
+    CCoinsView coinsDummy;
+    CCoinsViewCache coinsTip(&coinsDummy);
+    const std::vector<COutPoint> vSpent = RandomOutpoints(CACHE_BENCH_COINS);
+    const std::vector<COutPoint> vAdded = RandomOutpoints(CACHE_BENCH_COINS);
+    for (const COutPoint& outpoint : vSpent) {
+        coinsTip.AddCoin(outpoint, Coin(out, 1, false, false), false);
+    }
+
+    while (state.KeepRunning()) {
+        CCoinsViewCache view(&coinsTip);
+        for (const COutPoint& outpoint : vSpent) {
+            assert(!view.AccessCoin(outpoint).IsSpent());
+            view.SpendCoin(outpoint);
+        }
+        for (const COutPoint& outpoint : vAdded) {
+            view.AddCoin(outpoint, Coin(out, 2, false, false), false);
+        }
+    }
+}
+
+// Pushing a connected block's changes down into the tip
+static void CCoinsCaching_Flush(benchmark::State& state)
+{
+    const CTxOut out(COIN, GetScriptForDestination(CKeyID()));
+    CCoinsView coinsDummy;
+    const std::vector<COutPoint> vAdded = RandomOutpoints(CACHE_BENCH_COINS);
+
+    while (state.KeepRunning()) {
+        CCoinsViewCache coinsTip(&coinsDummy);
+        CCoinsViewCache view(&coinsTip);
+        for (const COutPoint& outpoint : vAdded) {
+            view.AddCoin(outpoint, Coin(out, 2, false, false), false);
+        }
+        bool flushed = view.Flush();
+        assert(flushed);
+    }
+}
+
+BENCHMARK(CCoinsCaching_SpendAdd, 2000);
+BENCHMARK(CCoinsCaching_Flush, 1500);
@@ -0,0 +1,107 @@
+// Copyright (c) 2016-2017 The Bitcoin Core developers
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "consensus/merkle.h"
+#include "consensus/validation.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "script/standard.h"
+#include "streams.h"
+#include "validation.h"
+#include "version.h"
+
+// The fixture is a synthetic, deterministic block of 2000 two-in two-out P2PKH
+// spends (about 750 kB, the size of a busy mainnet block). The signatures are
+// random bytes of the right length: deserialization and the context-free checks
+// don't look at them.
+
+static const int FIXTURE_BLOCK_TXES = 2000;
+
+static CBlock CreateFixtureBlock()
+{
+    FastRandomContext rng(true);
+    CBlock block;
+    block.nVersion = 4;
+    block.nTime = 1600000000;
+    block.nBits = 0x207fffff;
+    block.hashPrevBlock = rng.rand256();
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].scriptSig = CScript() << 1000 << OP_0;
+    coinbase.vout.emplace_back(250 * COIN, GetScriptForDestination(CKeyID(uint160(rng.randbytes(20)))));
+    block.vtx.emplace_back(MakeTransactionRef(coinbase));
+
+    for (int i = 1; i < FIXTURE_BLOCK_TXES; i++) {
+        CMutableTransaction tx;
+        for (int j = 0; j < 2; j++) {
+            tx.vin.emplace_back(COutPoint(rng.rand256(), j));
+            tx.vin.back().scriptSig = CScript() << rng.randbytes(72) << rng.randbytes(33);
+            tx.vout.emplace_back(COIN + rng.randrange(COIN), GetScriptForDestination(CKeyID(uint160(rng.randbytes(20)))));
+        }
+        block.vtx.emplace_back(MakeTransactionRef(tx));
+    }
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    return block;
+}
+
+static const std::vector<unsigned char>& FixtureBlockData()
+{
+    static const std::vector<unsigned char> data = [] {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << CreateFixtureBlock();
+        return std::vector<unsigned char>(stream.begin(), stream.end());
+    }();
+    return data;
+}
+
+static void DeserializeBlockTest(benchmark::State& state)
+{
+    CDataStream stream(FixtureBlockData(), SER_NETWORK, PROTOCOL_VERSION);
+    char a = '\0';
+    stream.write(&a, 1); // Prevent compaction
+
+    while (state.KeepRunning()) {
+        CBlock block;
+        stream >> block;
+        bool rewound = stream.Rewind(FixtureBlockData().size());
+        assert(rewound);
+    }
+}
+
+static void DeserializeAndCheckBlockTest(benchmark::State& state)
+{
+    CDataStream stream(FixtureBlockData(), SER_NETWORK, PROTOCOL_VERSION);
+    char a = '\0';
+    stream.write(&a, 1); // Prevent compaction
+
+    LOCK(cs_main);
+    while (state.KeepRunning()) {
+        CBlock block; // Note that CBlock caches its checked state, so we need to recreate it here
+        stream >> block;
+        bool rewound = stream.Rewind(FixtureBlockData().size());
+        assert(rewound);
+
+        CValidationState validationState;
+        bool checked = CheckBlock(block, validationState, false, true, false);
+        assert(checked);
+    }
+}
+
+static void MerkleRoot(benchmark::State& state)
+{
+    static const CBlock block = CreateFixtureBlock();
+    while (state.KeepRunning()) {
+        bool mutated = false;
+        uint256 root = BlockMerkleRoot(block, &mutated);
+        assert(root == block.hashMerkleRoot && !mutated);
+    }
+}
+
+BENCHMARK(DeserializeBlockTest, 130);
+BENCHMARK(DeserializeAndCheckBlockTest, 60);
+BENCHMARK(MerkleRoot, 800);
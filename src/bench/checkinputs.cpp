@@ -0,0 +1,112 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "coins.h"
+#include "consensus/validation.h"
+#include "key.h"
+#include "policy/policy.h"
+#include "random.h"
+#include "script/interpreter.h"
+#include "script/standard.h"
+#include "validation.h"
+
+/**
+ * A coins view holding nInputs P2PKH coins of a fresh key, and a transaction
+ * spending all of them with valid signatures. Every fixture uses its own key,
+ * so the entries one benchmark leaves in the signature cache never serve another.
+ */
+class SpendFixture
+{
+public:
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins{&coinsDummy};
+    CTransactionRef tx;
+
+    explicit SpendFixture(int nInputs)
+    {
+        CKey key;
+        key.MakeNewKey(true);
+        const CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+        CMutableTransaction mtx;
+        for (int i = 0; i < nInputs; i++) {
+            const COutPoint prevout(GetRandHash(), 0);
+            coins.AddCoin(prevout, Coin(CTxOut(COIN, scriptPubKey), 1, false, false), false);
+            mtx.vin.emplace_back(prevout);
+        }
+        mtx.vout.emplace_back(nInputs * COIN - 10000, scriptPubKey);
+
+        const CTransaction txToSign(mtx);
+        const PrecomputedTransactionData txdata(txToSign);
+        for (int i = 0; i < nInputs; i++) {
+            const uint256 hash = SignatureHash(scriptPubKey, txToSign, i, SIGHASH_ALL, COIN, SIGVERSION_BASE, &txdata);
+            std::vector<unsigned char> vchSig;
+            bool signed_ok = key.Sign(hash, vchSig);
+            assert(signed_ok);
+            vchSig.push_back((unsigned char)SIGHASH_ALL);
+            mtx.vin[i].scriptSig = CScript() << vchSig << ToByteVector(key.GetPubKey());
+        }
+        tx = MakeTransactionRef(mtx);
+
+        // CheckInputs takes the spend height from the block index entry of the view's best block
+        hashBest = GetRandHash();
+        index.nHeight = 1000;
+        index.phashBlock = &hashBest;
+        coins.SetBestBlock(hashBest);
+        LOCK(cs_main);
+        mapBlockIndex.emplace(hashBest, &index);
+    }
+
+    ~SpendFixture()
+    {
+        LOCK(cs_main);
+        mapBlockIndex.erase(hashBest);
+    }
+
+private:
+    uint256 hashBest;
+    CBlockIndex index;
+};
+
+static void RunCheckInputs(benchmark::State& state, bool cacheStore)
+{
+    SpendFixture fixture(100);
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        PrecomputedTransactionData txdata(*fixture.tx);
+        bool checked = CheckInputs(*fixture.tx, validationState, fixture.coins, true, STANDARD_SCRIPT_VERIFY_FLAGS, cacheStore, txdata);
+        assert(checked);
+    }
+}
+
+// A 100-input spend seen for the first time (e.g. in a block that was not relayed first)
+static void CheckInputs_NoSigCache(benchmark::State& state)
+{
+    RunCheckInputs(state, false);
+}
+
+// The same spend, after its signatures were verified and cached on mempool acceptance
+static void CheckInputs_SigCache(benchmark::State& state)
+{
+    RunCheckInputs(state, true);
+}
+
+// Every SIGHASH_ALL digest of a 500-input legacy transaction, as signing or verifying it needs
+static void SignatureHashLegacy(benchmark::State& state)
+{
+    SpendFixture fixture(500);
+    const CScript& scriptCode = fixture.coins.AccessCoin(fixture.tx->vin[0].prevout).out.scriptPubKey;
+    while (state.KeepRunning()) {
+        const PrecomputedTransactionData txdata(*fixture.tx);
+        for (unsigned int i = 0; i < fixture.tx->vin.size(); i++) {
+            SignatureHash(scriptCode, *fixture.tx, i, SIGHASH_ALL, COIN, SIGVERSION_BASE, &txdata);
+        }
+    }
+}
+
+BENCHMARK(CheckInputs_NoSigCache, 40);
+BENCHMARK(CheckInputs_SigCache, 2000);
+BENCHMARK(SignatureHashLegacy, 20);
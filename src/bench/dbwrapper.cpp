@@ -0,0 +1,33 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "dbwrapper.h"
+#include "random.h"
+
+// A coins-sized write batch (1000 entries of 64 bytes under 33-byte keys) committed
+// to an in-memory LevelDB, as FlushStateToDisk does in chunks of -dbbatchsize.
+// Keys are drawn from a fixed set so compaction keeps the database size bounded.
+static void LevelDBBatchWrite(benchmark::State& state)
+{
+    CDBWrapper db(fs::path("bench_leveldb"), 8 << 20, true, false);
+    FastRandomContext rng(true);
+    const std::vector<unsigned char> value = rng.randbytes(64);
+    std::vector<uint256> keys(100000);
+    for (uint256& key : keys) {
+        key = rng.rand256();
+    }
+
+    while (state.KeepRunning()) {
+        CDBBatch batch;
+        for (int i = 0; i < 1000; i++) {
+            batch.Write(std::make_pair('C', keys[rng.randrange(keys.size())]), value);
+        }
+        bool written = db.WriteBatch(batch);
+        assert(written);
+    }
+}
+
+BENCHMARK(LevelDBBatchWrite, 300);
@@ -0,0 +1,53 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "bls/bls_wrapper.h"
+#include "evo/deterministicmns.h"
+#include "key.h"
+#include "netbase.h"
+#include "random.h"
+
+/** A list of nCount confirmed masternodes, each with its own keys, address and collateral */
+static CDeterministicMNList CreateMNList(int nCount)
+{
+    CDeterministicMNList mnList(GetRandHash(), 1000, 0);
+    for (int i = 0; i < nCount; i++) {
+        CBLSSecretKey operatorKey;
+        operatorKey.MakeNewKey();
+        CKey ownerKey;
+        ownerKey.MakeNewKey(true);
+
+        auto dmn = std::make_shared<CDeterministicMN>(i);
+        dmn->proTxHash = GetRandHash();
+        dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+        dmn->nOperatorReward = 0;
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        dmnState->nRegisteredHeight = 1;
+        dmnState->keyIDOwner = ownerKey.GetPubKey().GetID();
+        dmnState->keyIDVoting = dmnState->keyIDOwner;
+        dmnState->pubKeyOperator.Set(operatorKey.GetPublicKey());
+        dmnState->addr = LookupNumeric(strprintf("10.%d.%d.%d", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff), 51472);
+        dmnState->UpdateConfirmedHash(dmn->proTxHash, GetRandHash());
+        dmn->pdmnState = dmnState;
+        mnList.AddMN(dmn);
+    }
+    return mnList;
+}
+
+// Quorum selection for a new modifier over a 1000 masternode list (done for every
+// LLMQ type at each quorum height, and again when checking commitments)
+static void DeterministicMNCalculateQuorum(benchmark::State& state)
+{
+    const CDeterministicMNList mnList = CreateMNList(1000);
+    uint256 modifier = GetRandHash();
+    while (state.KeepRunning()) {
+        auto quorum = mnList.CalculateQuorum(50, modifier);
+        assert(quorum.size() == 50);
+        modifier = quorum[0]->proTxHash;
+    }
+}
+
+BENCHMARK(DeterministicMNCalculateQuorum, 1000);
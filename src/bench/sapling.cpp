@@ -0,0 +1,129 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "random.h"
+#include "sapling/address.h"
+#include "sapling/incrementalmerkletree.h"
+#include "sapling/note.h"
+#include "sapling/transaction_builder.h"
+#include "util/system.h"
+
+#include <librustzcash.h>
+
+#include <iostream>
+
+/** An output note to a fresh spending key, encrypted as it would appear on chain */
+struct EncryptedNoteFixture
+{
+    libzcash::SaplingSpendingKey sk;
+    libzcash::SaplingNote note;
+    std::array<unsigned char, ZC_MEMO_SIZE> memo{};
+    libzcash::SaplingEncCiphertext ciphertext;
+    uint256 epk;
+    uint256 cmu;
+
+    EncryptedNoteFixture() : sk(libzcash::SaplingSpendingKey::random()), note(sk.default_address(), 5 * COIN)
+    {
+        auto res = libzcash::SaplingNotePlaintext(note, memo).encrypt(note.pk_d);
+        assert(res);
+        ciphertext = res->first;
+        epk = res->second.get_epk();
+        cmu = *note.cmu();
+    }
+};
+
+// The wallet tries every shielded output of every block with each of its keys: almost all attempts fail
+static void SaplingTrialDecrypt_NoMatch(benchmark::State& state)
+{
+    const EncryptedNoteFixture fixture;
+    const uint256 ivk = libzcash::SaplingSpendingKey::random().full_viewing_key().in_viewing_key();
+    while (state.KeepRunning()) {
+        bool decrypted = (bool)libzcash::SaplingNotePlaintext::decrypt(fixture.ciphertext, ivk, fixture.epk, fixture.cmu);
+        assert(!decrypted);
+    }
+}
+
+static void SaplingTrialDecrypt_Match(benchmark::State& state)
+{
+    const EncryptedNoteFixture fixture;
+    const uint256 ivk = fixture.sk.full_viewing_key().in_viewing_key();
+    while (state.KeepRunning()) {
+        bool decrypted = (bool)libzcash::SaplingNotePlaintext::decrypt(fixture.ciphertext, ivk, fixture.epk, fixture.cmu);
+        assert(decrypted);
+    }
+}
+
+static bool LoadSaplingParams()
+{
+    try {
+        initZKSNARKS();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Skipping Sapling proof benchmarks: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// The proof check SaplingValidation::ContextualCheckTransaction runs on every shielded output
+static void SaplingOutputProofVerify(benchmark::State& state)
+{
+    static const bool fParamsLoaded = LoadSaplingParams();
+    if (!fParamsLoaded) return;
+
+    EncryptedNoteFixture fixture;
+    void* proveCtx = librustzcash_sapling_proving_ctx_init();
+    Optional<OutputDescription> odesc = OutputDescriptionInfo(uint256(), fixture.note, fixture.memo).Build(proveCtx);
+    librustzcash_sapling_proving_ctx_free(proveCtx);
+    assert(odesc);
+
+    while (state.KeepRunning()) {
+        void* ctx = librustzcash_sapling_verification_ctx_init();
+        bool verified = librustzcash_sapling_check_output(ctx, odesc->cv.begin(), odesc->cmu.begin(),
+                                                          odesc->ephemeralKey.begin(), odesc->zkproof.begin());
+        librustzcash_sapling_verification_ctx_free(ctx);
+        assert(verified);
+    }
+}
+
+static std::vector<libzcash::PedersenHash> RandomCommitments(size_t n)
+{
+    std::vector<libzcash::PedersenHash> vCommitments;
+    for (size_t i = 0; i < n; i++) {
+        vCommitments.emplace_back(GetRandHash());
+    }
+    return vCommitments;
+}
+
+// ConnectBlock: append the commitments of a block with many shielded outputs, then push the anchor
+static void SaplingTreeAppendBlock(benchmark::State& state)
+{
+    SaplingMerkleTree base;
+    base.append_batch(RandomCommitments(1000));
+    const std::vector<libzcash::PedersenHash> vBlock = RandomCommitments(200);
+    while (state.KeepRunning()) {
+        SaplingMerkleTree tree(base);
+        tree.append_batch(vBlock);
+        tree.root();
+    }
+}
+
+// ConnectBlock of a block without shielded outputs: the anchor root is read back, not recomputed
+static void SaplingTreeRootUnchanged(benchmark::State& state)
+{
+    SaplingMerkleTree tree;
+    tree.append_batch(RandomCommitments(1000));
+    tree.root();
+    while (state.KeepRunning()) {
+        SaplingMerkleTree copy(tree);
+        copy.root();
+    }
+}
+
+BENCHMARK(SaplingTrialDecrypt_NoMatch, 8000);
+BENCHMARK(SaplingTrialDecrypt_Match, 4000);
+BENCHMARK(SaplingOutputProofVerify, 150);
+BENCHMARK(SaplingTreeAppendBlock, 20);
+BENCHMARK(SaplingTreeRootUnchanged, 100000);
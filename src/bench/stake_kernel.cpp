@@ -0,0 +1,38 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/bench.h"
+
+#include "chain.h"
+#include "kernel.h"
+#include "random.h"
+#include "script/standard.h"
+
+// What the staker does for each of its UTXOs at each time slot: build the
+// kernel on top of the tip and test its hash against the weighted target.
+static void StakeKernelCheckHash(benchmark::State& state)
+{
+    CBlockIndex indexGenesis;
+    CBlockIndex indexFrom;
+    indexFrom.pprev = &indexGenesis;
+    indexFrom.nHeight = 1;
+    indexFrom.nTime = 1600000000;
+    indexFrom.SetNewStakeModifier(GetRandHash());
+    CBlockIndex indexPrev;
+    indexPrev.pprev = &indexFrom;
+    indexPrev.nHeight = 1000;
+    indexPrev.nTime = indexFrom.nTime + 60 * 1000;
+    indexPrev.SetNewStakeModifier(GetRandHash());
+
+    CBczStake stakeInput(CTxOut(1000 * COIN, GetScriptForDestination(CKeyID())),
+                         COutPoint(GetRandHash(), 1), &indexFrom);
+    const unsigned int nBits = 0x1b0404cb;
+    int nTime = indexPrev.nTime;
+    while (state.KeepRunning()) {
+        CStakeKernel kernel(&indexPrev, &stakeInput, nBits, ++nTime);
+        kernel.CheckKernelHash(true);
+    }
+}
+
+BENCHMARK(StakeKernelCheckHash, 700 * 1000);
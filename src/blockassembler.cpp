@@ -499,13 +499,15 @@ uint256 CalculateSaplingTreeRoot(CBlock* pblock, int nHeight, const CChainParams
         assert(pcoinsTip->GetSaplingAnchorAt(pcoinsTip->GetBestAnchor(), sapling_tree));
 
         // Update the Sapling commitment tree.
+        std::vector<libzcash::PedersenHash> vCommitments;
         for (const auto &tx : pblock->vtx) {
             if (tx->IsShieldedTx()) {
                 for (const OutputDescription &odesc : tx->sapData->vShieldedOutput) {
-                    sapling_tree.append(odesc.cmu);
+                    vCommitments.push_back(odesc.cmu);
                 }
             }
         }
+        sapling_tree.append_batch(vCommitments);
         return sapling_tree.root();
 }
 
@@ -0,0 +1,114 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilecache.h"
+
+#include "crypto/common.h"
+#include "serialize.h"
+#include "util/system.h"
+
+CBlockFileReader::CBlockFileReader(OpenFileFn openFileIn, size_t nMaxOpenFilesIn, size_t nMaxCacheBytesIn) :
+    openFile(openFileIn),
+    nMaxOpenFiles(nMaxOpenFilesIn),
+    nMaxCacheBytes(nMaxCacheBytesIn)
+{
+}
+
+std::shared_ptr<CBlockFileReader::OpenFile> CBlockFileReader::GetFile(int nFile)
+{
+    {
+        LOCK(cs);
+        for (auto it = lruFiles.begin(); it != lruFiles.end(); ++it) {
+            if (it->first == nFile) {
+                lruFiles.splice(lruFiles.begin(), lruFiles, it);
+                return it->second;
+            }
+        }
+    }
+
+    FILE* file = openFile(FlatFilePos(nFile, 0), true);
+    if (!file) {
+        return nullptr;
+    }
+    // Records are read whole, so stdio buffering would only add a copy
+    setvbuf(file, nullptr, _IONBF, 0);
+    auto handle = std::make_shared<OpenFile>(file);
+
+    LOCK(cs);
+    lruFiles.emplace_front(nFile, handle);
+    if (lruFiles.size() > nMaxOpenFiles) {
+        // Readers still holding the handle keep it open until they are done
+        lruFiles.pop_back();
+    }
+    return handle;
+}
+
+bool CBlockFileReader::ReadFromFile(const FlatFilePos& pos, size_t nTrailerSize, std::vector<unsigned char>& vch)
+{
+    if (pos.nPos < 8) {
+        return error("%s: invalid record position %s", __func__, pos.ToString());
+    }
+    std::shared_ptr<OpenFile> handle = GetFile(pos.nFile);
+    if (!handle) {
+        return error("%s: unable to open file %i", __func__, pos.nFile);
+    }
+
+    LOCK(handle->cs);
+    unsigned char size[4];
+    if (fseek(handle->file, pos.nPos - 4, SEEK_SET) || fread(size, 1, sizeof(size), handle->file) != sizeof(size)) {
+        return error("%s: failed to read record size at %s", __func__, pos.ToString());
+    }
+    const uint32_t nSize = ReadLE32(size);
+    if (nSize > MAX_SIZE) {
+        return error("%s: record size %u too large at %s", __func__, nSize, pos.ToString());
+    }
+    vch.resize(nSize + nTrailerSize);
+    if (fread(vch.data(), 1, vch.size(), handle->file) != vch.size()) {
+        return error("%s: short read at %s", __func__, pos.ToString());
+    }
+    return true;
+}
+
+bool CBlockFileReader::Read(const FlatFilePos& pos, size_t nTrailerSize, RecordRef& recordOut)
+{
+    const RecordKey key(pos.nFile, pos.nPos);
+    {
+        LOCK(cs);
+        auto it = mapRecords.find(key);
+        if (it != mapRecords.end()) {
+            lruRecords.splice(lruRecords.begin(), lruRecords, it->second);
+            recordOut = it->second->second;
+            return true;
+        }
+    }
+
+    auto vch = std::make_shared<std::vector<unsigned char>>();
+    if (!ReadFromFile(pos, nTrailerSize, *vch)) {
+        return false;
+    }
+    recordOut = vch;
+
+    LOCK(cs);
+    if (vch->size() > nMaxCacheBytes || mapRecords.count(key)) {
+        return true;
+    }
+    lruRecords.emplace_front(key, recordOut);
+    mapRecords.emplace(key, lruRecords.begin());
+    nCacheBytes += vch->size();
+    while (nCacheBytes > nMaxCacheBytes) {
+        nCacheBytes -= lruRecords.back().second->size();
+        mapRecords.erase(lruRecords.back().first);
+        lruRecords.pop_back();
+    }
+    return true;
+}
+
+void CBlockFileReader::Clear()
+{
+    LOCK(cs);
+    lruFiles.clear();
+    lruRecords.clear();
+    mapRecords.clear();
+    nCacheBytes = 0;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_BLOCKFILECACHE_H
+#define BCZ_BLOCKFILECACHE_H
+
+#include "flatfile.h"
+#include "sync.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Read side of the blk/rev file storage.
+ *
+ * Records (a block, or an undo entry with its checksum) are written as
+ * <magic><size><data>, and once written they never change, so this keeps:
+ *  - a small LRU of read-only file handles, so that repeated reads don't
+ *    pay an fopen/fclose each time;
+ *  - a byte-bounded LRU of the most recently read records, handed out as
+ *    shared immutable buffers that callers deserialize in place (see
+ *    SpanReader), so peers asking for the same recent blocks, getblock and
+ *    reorg handling don't hit the disk again.
+ */
+class CBlockFileReader
+{
+public:
+    typedef FILE* (*OpenFileFn)(const FlatFilePos& pos, bool fReadOnly);
+    typedef std::shared_ptr<const std::vector<unsigned char>> RecordRef;
+
+    CBlockFileReader(OpenFileFn openFileIn, size_t nMaxOpenFilesIn, size_t nMaxCacheBytesIn);
+
+    /**
+     * Read the record stored at pos, plus nTrailerSize bytes following it.
+     * pos points past the 8-byte header, as recorded in the block index.
+     */
+    bool Read(const FlatFilePos& pos, size_t nTrailerSize, RecordRef& recordOut);
+
+    /** Close every handle and drop the cached records (e.g. before files are deleted) */
+    void Clear();
+
+private:
+    struct OpenFile
+    {
+        Mutex cs;
+        FILE* file;
+
+        explicit OpenFile(FILE* fileIn) : file(fileIn) {}
+        ~OpenFile() { fclose(file); }
+    };
+    typedef std::pair<int, unsigned int> RecordKey;
+    typedef std::list<std::pair<RecordKey, RecordRef>> RecordList;
+
+    std::shared_ptr<OpenFile> GetFile(int nFile);
+    bool ReadFromFile(const FlatFilePos& pos, size_t nTrailerSize, std::vector<unsigned char>& vch);
+
+    const OpenFileFn openFile;
+    const size_t nMaxOpenFiles;
+    const size_t nMaxCacheBytes;
+
+    Mutex cs;
+    //! Most recently used first
+    std::list<std::pair<int, std::shared_ptr<OpenFile>>> lruFiles GUARDED_BY(cs);
+    RecordList lruRecords GUARDED_BY(cs);
+    std::map<RecordKey, RecordList::iterator> mapRecords GUARDED_BY(cs);
+    size_t nCacheBytes GUARDED_BY(cs){0};
+};
+
+#endif // BCZ_BLOCKFILECACHE_H
@@ -67,10 +67,12 @@ void CBLSWorker::Start()
     workerPool.resize(workerCount);
 
     RenameThreadPool(workerPool, "bcz-bls-worker");
+    fRunning = true;
 }
 
 void CBLSWorker::Stop()
 {
+    fRunning = false;
     workerPool.clear_queue();
     workerPool.stop(true);
 }
@@ -9,6 +9,7 @@
 #include "bls/bls_wrapper.h"
 #include "ctpl_stl.h"
 
+#include <atomic>
 #include <future>
 #include <mutex>
 
@@ -47,12 +48,16 @@ private:
     int sigVerifyBatchesInProgress{0};
     std::vector<SigVerifyJob> sigVerifyQueue;
 
+    std::atomic<bool> fRunning{false};
+
 public:
     CBLSWorker();
     ~CBLSWorker();
 
     void Start();
     void Stop();
+    // Async jobs only complete while the worker threads are running
+    bool IsRunning() const { return fRunning; }
 
     bool GenerateContributions(int threshold, const BLSIdVector& ids, BLSVerificationVectorPtr& vvecRet, BLSSecretKeyVector& skShares);
 
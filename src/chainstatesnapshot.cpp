@@ -0,0 +1,252 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainstatesnapshot.h"
+
+#include "clientversion.h"
+#include "evo/evodb.h"
+#include "hash.h"
+#include "streams.h"
+#include "txdb.h"
+#include "validation.h"
+
+#include <functional>
+
+#include <boost/thread.hpp>
+
+static const char SNAPSHOT_MAGIC[8] = {'b', 'c', 'z', 's', 'n', 'a', 'p', 0};
+//! Best block marker keys of the chainstate (see txdb.cpp) and evo databases
+static const char DB_BEST_BLOCK = 'B';
+
+typedef std::function<void(const std::vector<unsigned char>&, const std::vector<unsigned char>&)> SnapshotEntryFn;
+
+/** Copy every key/value of db, as seen by the iterator, into the snapshot file */
+static uint64_t WriteSnapshotSection(CAutoFile& file, CHashWriter& hasher, CDBIterator& it)
+{
+    uint64_t nEntries = 0;
+    std::vector<unsigned char> key, value;
+    for (it.SeekToFirst(); it.Valid(); it.Next()) {
+        if (nEntries % 100000 == 0) boost::this_thread::interruption_point();
+        const leveldb::Slice slKey = it.GetRawKey();
+        const leveldb::Slice slValue = it.GetRawValue();
+        key.assign(slKey.data(), slKey.data() + slKey.size());
+        value.assign(slValue.data(), slValue.data() + slValue.size());
+        file << (uint8_t)1 << key << value;
+        hasher << key << value;
+        nEntries++;
+    }
+    file << (uint8_t)0;
+    return nEntries;
+}
+
+static uint64_t ReadSnapshotSection(CAutoFile& file, CHashWriter& hasher, const SnapshotEntryFn& fn)
+{
+    uint64_t nEntries = 0;
+    std::vector<unsigned char> key, value;
+    while (true) {
+        uint8_t fMore;
+        file >> fMore;
+        if (!fMore) break;
+        file >> key >> value;
+        hasher << key << value;
+        fn(key, value);
+        nEntries++;
+    }
+    return nEntries;
+}
+
+/** Parse the whole snapshot, calling the handlers on every entry, and check its content hash */
+static bool ReadSnapshot(const fs::path& path, ChainstateSnapshotMetadata& metadata,
+                         const SnapshotEntryFn& coinsFn, const SnapshotEntryFn& evoFn, std::string& strError)
+{
+    CAutoFile file(fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        strError = strprintf("unable to open %s", path.string());
+        return false;
+    }
+    try {
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        uint32_t nVersion;
+        file.read(magic, sizeof(magic));
+        file >> nVersion;
+        if (memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) || nVersion != CHAINSTATE_SNAPSHOT_VERSION) {
+            strError = "not a chainstate snapshot, or unsupported snapshot version";
+            return false;
+        }
+        file >> metadata;
+
+        CHashWriter hasher(SER_GETHASH, 0);
+        hasher << nVersion << metadata;
+        metadata.nCoinsDBEntries = ReadSnapshotSection(file, hasher, coinsFn);
+        metadata.nEvoDBEntries = ReadSnapshotSection(file, hasher, evoFn);
+        metadata.hashContent = hasher.GetHash();
+
+        uint256 hashExpected;
+        file >> hashExpected;
+        if (hashExpected != metadata.hashContent) {
+            strError = strprintf("content hash mismatch (expected %s, got %s)", hashExpected.ToString(), metadata.hashContent.ToString());
+            return false;
+        }
+    } catch (const std::exception& e) {
+        strError = strprintf("failed to read snapshot: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool DumpChainstateSnapshot(const fs::path& path, ChainstateSnapshotMetadata& metadata, std::string& strError)
+{
+    if (fs::exists(path)) {
+        strError = strprintf("%s already exists", path.string());
+        return false;
+    }
+
+    std::unique_ptr<CDBIterator> pcoinsIt;
+    std::unique_ptr<CDBIterator> pevoIt;
+    {
+        LOCK(cs_main);
+        // Write the coins cache and the evo transaction down, then pin both databases
+        FlushStateToDisk();
+        metadata.hashBlock = pcoinsdbview->GetBestBlock();
+        const CBlockIndex* pindex = LookupBlockIndex(metadata.hashBlock);
+        if (!pindex || !evoDb->VerifyBestBlock(metadata.hashBlock)) {
+            strError = "chainstate and evo databases are not at a common block";
+            return false;
+        }
+        metadata.nHeight = pindex->nHeight;
+        pcoinsIt.reset(pcoinsdbview->GetRawDB().NewIterator());
+        pevoIt.reset(evoDb->GetRawDB().NewIterator());
+    }
+
+    const fs::path pathTmp = path.string() + ".incomplete";
+    try {
+        CAutoFile file(fsbridge::fopen(pathTmp, "wb"), SER_DISK, CLIENT_VERSION);
+        if (file.IsNull()) {
+            strError = strprintf("unable to open %s for writing", pathTmp.string());
+            return false;
+        }
+        const uint32_t nVersion = CHAINSTATE_SNAPSHOT_VERSION;
+        file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        file << nVersion << metadata;
+
+        CHashWriter hasher(SER_GETHASH, 0);
+        hasher << nVersion << metadata;
+        metadata.nCoinsDBEntries = WriteSnapshotSection(file, hasher, *pcoinsIt);
+        metadata.nEvoDBEntries = WriteSnapshotSection(file, hasher, *pevoIt);
+        metadata.hashContent = hasher.GetHash();
+        file << metadata.hashContent;
+
+        if (!FileCommit(file.Get()))
+            throw std::runtime_error("FileCommit failed");
+        file.fclose();
+        if (!RenameOver(pathTmp, path))
+            throw std::runtime_error("Rename failed");
+    } catch (const std::exception& e) {
+        fs::remove(pathTmp);
+        strError = strprintf("failed to write snapshot: %s", e.what());
+        return false;
+    }
+
+    LogPrintf("Dumped chainstate snapshot at block %s (height %d): %u coins db entries, %u evo db entries, hash %s\n",
+              metadata.hashBlock.ToString(), metadata.nHeight, metadata.nCoinsDBEntries, metadata.nEvoDBEntries, metadata.hashContent.ToString());
+    return true;
+}
+
+/**
+ * Batches raw writes into a database, replacing whatever it held before.
+ * The best block marker is held back and written last, so an interrupted
+ * import never leaves a database that claims to be at the snapshot block.
+ */
+class SnapshotDBWriter
+{
+public:
+    template <typename K>
+    SnapshotDBWriter(CDBWrapper& _db, const K& markerKey) : db(_db), ssMarkerKey(SER_DISK, CLIENT_VERSION)
+    {
+        ssMarkerKey << markerKey;
+        vchMarkerKey.assign(ssMarkerKey.begin(), ssMarkerKey.end());
+        std::unique_ptr<CDBIterator> it(db.NewIterator());
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            batch.Erase(it->GetKey());
+            FlushIfNeeded();
+        }
+    }
+
+    void Write(const std::vector<unsigned char>& key, const std::vector<unsigned char>& value)
+    {
+        if (key == vchMarkerKey) {
+            vchMarkerValue = value;
+            return;
+        }
+        CDataStream ssKey(key, SER_DISK, CLIENT_VERSION);
+        batch.Write(ssKey, MakeSpan(value));
+        FlushIfNeeded();
+    }
+
+    bool Finish()
+    {
+        if (!db.WriteBatch(batch, true)) return false;
+        batch.Clear();
+        if (!vchMarkerValue.empty()) {
+            batch.Write(ssMarkerKey, MakeSpan(vchMarkerValue));
+        }
+        return db.WriteBatch(batch, true);
+    }
+
+private:
+    void FlushIfNeeded()
+    {
+        if (batch.SizeEstimate() > (size_t)nDefaultDbBatchSize) {
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+
+    CDBWrapper& db;
+    CDBBatch batch;
+    CDataStream ssMarkerKey;
+    std::vector<unsigned char> vchMarkerKey;
+    std::vector<unsigned char> vchMarkerValue;
+};
+
+bool LoadChainstateSnapshot(const fs::path& path, CCoinsViewDB& coinsdb, ChainstateSnapshotMetadata& metadata, std::string& strError)
+{
+    AssertLockHeld(cs_main);
+    if (!coinsdb.GetBestBlock().IsNull()) {
+        strError = "the chainstate database is not empty";
+        return false;
+    }
+
+    // First pass: validate the whole file before touching the databases
+    const auto skip = [](const std::vector<unsigned char>&, const std::vector<unsigned char>&) {};
+    if (!ReadSnapshot(path, metadata, skip, skip, strError)) {
+        return false;
+    }
+    const CBlockIndex* pindex = LookupBlockIndex(metadata.hashBlock);
+    if (!pindex || pindex->nHeight != metadata.nHeight || !(pindex->nStatus & BLOCK_HAVE_DATA)) {
+        strError = strprintf("snapshot block %s is not in the block index, or its data is missing", metadata.hashBlock.ToString());
+        return false;
+    }
+
+    // Second pass: copy the entries into the databases
+    LOCK(evoDb->cs);
+    SnapshotDBWriter coinsWriter(coinsdb.GetRawDB(), DB_BEST_BLOCK);
+    SnapshotDBWriter evoWriter(evoDb->GetRawDB(), EVODB_BEST_BLOCK);
+    if (!ReadSnapshot(path, metadata,
+            std::bind(&SnapshotDBWriter::Write, &coinsWriter, std::placeholders::_1, std::placeholders::_2),
+            std::bind(&SnapshotDBWriter::Write, &evoWriter, std::placeholders::_1, std::placeholders::_2),
+            strError)) {
+        return false;
+    }
+    // The coins best block goes last: until it is written the chainstate still looks empty
+    if (!evoWriter.Finish() || !coinsWriter.Finish()) {
+        strError = "failed to write the snapshot entries";
+        return false;
+    }
+    evoDb->ClearReadCache();
+
+    LogPrintf("Loaded chainstate snapshot at block %s (height %d): %u coins db entries, %u evo db entries, hash %s\n",
+              metadata.hashBlock.ToString(), metadata.nHeight, metadata.nCoinsDBEntries, metadata.nEvoDBEntries, metadata.hashContent.ToString());
+    return true;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_CHAINSTATESNAPSHOT_H
+#define BCZ_CHAINSTATESNAPSHOT_H
+
+#include "fs.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <string>
+
+class CCoinsViewDB;
+
+static const uint32_t CHAINSTATE_SNAPSHOT_VERSION = 1;
+
+/**
+ * Header of a chainstate snapshot file. The body holds, verbatim, every
+ * key/value of the chainstate database (coins, Sapling anchors and
+ * nullifiers, best block markers) followed by every key/value of the evo
+ * database (deterministic MN lists, LLMQ commitments), and ends with the
+ * content hash of header and entries.
+ */
+struct ChainstateSnapshotMetadata
+{
+    uint256 hashBlock;
+    int nHeight{0};
+    uint64_t nCoinsDBEntries{0};
+    uint64_t nEvoDBEntries{0};
+    uint256 hashContent;
+
+    SERIALIZE_METHODS(ChainstateSnapshotMetadata, obj) { READWRITE(obj.hashBlock, obj.nHeight); }
+};
+
+/**
+ * Write a snapshot of the chainstate and evo databases at the current tip to path.
+ * The state is flushed first and read through LevelDB snapshots, so cs_main is only
+ * held while the iterators are created.
+ */
+bool DumpChainstateSnapshot(const fs::path& path, ChainstateSnapshotMetadata& metadata, std::string& strError);
+
+/**
+ * Import a snapshot written by DumpChainstateSnapshot into an empty chainstate.
+ * The content hash is verified before anything is written, and the snapshot block
+ * must already be in the block index with its data on disk.
+ * Must be called during init, after the block index and evo DB are loaded and
+ * before the coins cache is created.
+ */
+bool LoadChainstateSnapshot(const fs::path& path, CCoinsViewDB& coinsdb, ChainstateSnapshotMetadata& metadata, std::string& strError);
+
+#endif // BCZ_CHAINSTATESNAPSHOT_H
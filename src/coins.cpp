@@ -80,6 +80,18 @@ CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint& outpoint) const
     return ret;
 }
 
+void CCoinsViewCache::CacheFetchedCoin(const COutPoint& outpoint, Coin&& coin)
+{
+    CCoinsMap::iterator it;
+    bool inserted;
+    std::tie(it, inserted) = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(coin)));
+    if (!inserted) return;
+    if (it->second.coin.IsSpent()) {
+        it->second.flags = CCoinsCacheEntry::FRESH;
+    }
+    cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+}
+
 bool CCoinsViewCache::GetCoin(const COutPoint& outpoint, Coin& coin) const
 {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
@@ -353,6 +353,13 @@ public:
      */
     const Coin& AccessCoin(const COutPoint& output) const;
 
+    /**
+     * Cache a coin that was read from the backing view by someone else (the
+     * block input prefetch threads), unless the outpoint is cached already.
+     * The entry is left exactly as a FetchCoin miss would have left it.
+     */
+    void CacheFetchedCoin(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Add a coin. Set potential_overwrite to true if a non-pruned version may
      * already exist.
@@ -0,0 +1,197 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinstatsindex.h"
+
+#include "chain.h"
+#include "coins.h"
+#include "shutdown.h"
+#include "streams.h"
+#include "validation.h"
+
+std::unique_ptr<CCoinStatsIndex> g_coinStatsIndex;
+
+static const char DB_BLOCK_STATS = 's';
+static const char DB_BEST_STATS = 'B';
+
+namespace {
+
+/** The running statistics of the tip, as flushed with the coins */
+struct CoinStatsState
+{
+    uint256 hashBlock;
+    int nHeight{0};
+    CCoinStatsDelta totals;
+
+    SERIALIZE_METHODS(CoinStatsState, obj) { READWRITE(obj.hashBlock, obj.nHeight, obj.totals); }
+};
+
+/** A coin as an element of the UTXO set hash: outpoint, height and kind, output */
+void CoinHashElement(CDataStream& ss, const COutPoint& outpoint, const Coin& coin)
+{
+    ss << outpoint;
+    ss << (uint32_t)(coin.nHeight * 4 + (coin.fCoinBase ? 2u : 0u) + (coin.fCoinStake ? 1u : 0u));
+    ss << coin.out;
+}
+
+} // anon namespace
+
+void CCoinStatsDelta::AddCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    CoinHashElement(ss, outpoint, coin);
+    muhash.Insert(Span<const unsigned char>((const unsigned char*)ss.data(), ss.size()));
+    nTransactionOutputs++;
+    nTotalAmount += coin.out.nValue;
+}
+
+void CCoinStatsDelta::SpendCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    CoinHashElement(ss, outpoint, coin);
+    muhash.Remove(Span<const unsigned char>((const unsigned char*)ss.data(), ss.size()));
+    nTransactionOutputs--;
+    nTotalAmount -= coin.out.nValue;
+}
+
+CCoinStatsDelta& CCoinStatsDelta::operator+=(const CCoinStatsDelta& other)
+{
+    muhash *= other.muhash;
+    nTransactionOutputs += other.nTransactionOutputs;
+    nTotalAmount += other.nTotalAmount;
+    nShieldedAmount += other.nShieldedAmount;
+    return *this;
+}
+
+CCoinStatsIndex::CCoinStatsIndex(size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(GetDataDir() / "indexes" / "coinstats", nCacheSize, fMemory, fWipe)
+{
+}
+
+bool CCoinStatsIndex::Init(CCoinsView* coinsdb)
+{
+    CoinStatsState state;
+    if (db.Read(DB_BEST_STATS, state) && state.hashBlock == coinsdb->GetBestBlock()) {
+        LOCK(cs);
+        hashBestBlock = state.hashBlock;
+        nBestHeight = state.nHeight;
+        totals = state.totals;
+        LogPrintf("%s: coin statistics loaded at height %d\n", __func__, nBestHeight);
+        return true;
+    }
+    return Rebuild(coinsdb);
+}
+
+bool CCoinStatsIndex::Rebuild(CCoinsView* coinsdb)
+{
+    AssertLockHeld(cs_main);
+    LogPrintf("%s: computing the coin statistics of the UTXO set...\n", __func__);
+    const int64_t nStart = GetTimeMillis();
+
+    std::unique_ptr<CCoinsViewCursor> pcursor(coinsdb->Cursor());
+    CCoinStatsDelta stats;
+    while (pcursor->Valid()) {
+        if (ShutdownRequested()) return false;
+        COutPoint key;
+        Coin coin;
+        if (!pcursor->GetKey(key) || !pcursor->GetValue(coin)) {
+            return error("%s: unable to read coin", __func__);
+        }
+        stats.AddCoin(key, coin);
+        pcursor->Next();
+    }
+
+    // The coins do not hold the Sapling pool value. Take it from the entry of
+    // the best block, written when it was connected, and only read the blocks
+    // above the last entry when it is missing (first enable, lost writes).
+    const CBlockIndex* pindexBest = pcursor->GetBestBlock().IsNull() ? nullptr : LookupBlockIndex(pcursor->GetBestBlock());
+    if (!pcursor->GetBestBlock().IsNull() && !pindexBest) {
+        return error("%s: coins best block %s not found", __func__, pcursor->GetBestBlock().ToString());
+    }
+    int nBlocksRead = 0;
+    for (const CBlockIndex* pindex = pindexBest; pindex; pindex = pindex->pprev) {
+        if (ShutdownRequested()) return false;
+        CCoinStatsEntry entry;
+        if (LookUpStats(pindex, entry)) {
+            stats.nShieldedAmount += entry.nShieldedAmount;
+            break;
+        }
+        if (!(pindex->nStatus & BLOCK_HAVE_DATA)) {
+            // Chainstate loaded from a snapshot, without the history
+            LogPrintf("%s: no data for block %d, the Sapling pool value only counts the blocks above it\n", __func__, pindex->nHeight);
+            break;
+        }
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex)) {
+            return error("%s: failed to read block %s", __func__, pindex->GetBlockHash().ToString());
+        }
+        for (const auto& tx : block.vtx) {
+            if (tx->IsShieldedTx()) stats.nShieldedAmount -= tx->sapData->valueBalance;
+        }
+        nBlocksRead++;
+    }
+    if (nBlocksRead > 0) LogPrintf("%s: Sapling pool value summed up from %d blocks\n", __func__, nBlocksRead);
+
+    {
+        LOCK(cs);
+        hashBestBlock = pcursor->GetBestBlock();
+        nBestHeight = pindexBest ? pindexBest->nHeight : 0;
+        totals = std::move(stats);
+        if (pindexBest) WriteEntry();
+    }
+    LogPrintf("%s: coin statistics computed at height %d in %dms\n", __func__, pindexBest ? pindexBest->nHeight : 0, GetTimeMillis() - nStart);
+    return Flush();
+}
+
+void CCoinStatsIndex::WriteEntry()
+{
+    CCoinStatsEntry entry;
+    entry.nHeight = nBestHeight;
+    totals.muhash.Finalize(entry.hashMuHash);
+    entry.nTransactionOutputs = totals.nTransactionOutputs;
+    entry.nTotalAmount = totals.nTotalAmount;
+    entry.nShieldedAmount = totals.nShieldedAmount;
+    // Entries are keyed by block hash, so they stay valid when the block is disconnected
+    db.Write(std::make_pair(DB_BLOCK_STATS, hashBestBlock), entry);
+}
+
+void CCoinStatsIndex::BlockConnected(const CBlockIndex* pindex, const CCoinStatsDelta& delta)
+{
+    LOCK(cs);
+    totals += delta;
+    hashBestBlock = pindex->GetBlockHash();
+    nBestHeight = pindex->nHeight;
+    WriteEntry();
+}
+
+void CCoinStatsIndex::BlockDisconnected(const CBlockIndex* pindex, const CCoinStatsDelta& delta)
+{
+    LOCK(cs);
+    totals += delta;
+    hashBestBlock = pindex->pprev->GetBlockHash();
+    nBestHeight = pindex->pprev->nHeight;
+}
+
+bool CCoinStatsIndex::Flush()
+{
+    CoinStatsState state;
+    {
+        LOCK(cs);
+        state.hashBlock = hashBestBlock;
+        state.nHeight = nBestHeight;
+        state.totals = totals;
+    }
+    return db.Write(DB_BEST_STATS, state, true);
+}
+
+bool CCoinStatsIndex::LookUpStats(const CBlockIndex* pindex, CCoinStatsEntry& entry) const
+{
+    return db.Read(std::make_pair(DB_BLOCK_STATS, pindex->GetBlockHash()), entry);
+}
+
+CAmount CCoinStatsIndex::GetTotalAmount() const
+{
+    LOCK(cs);
+    return totals.nTotalAmount;
+}
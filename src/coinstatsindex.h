@@ -0,0 +1,107 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_COINSTATSINDEX_H
+#define BCZ_COINSTATSINDEX_H
+
+#include "amount.h"
+#include "crypto/muhash.h"
+#include "dbwrapper.h"
+#include "sync.h"
+#include "uint256.h"
+
+#include <memory>
+
+class CBlockIndex;
+class CCoinsView;
+class COutPoint;
+class Coin;
+
+//! -coinstatsindex default
+static const bool DEFAULT_COINSTATSINDEX = false;
+//! LevelDB cache of the index (MiB), entries are only read back by gettxoutsetinfo
+static const int64_t nCoinStatsIndexCache = 2;
+
+/**
+ * Statistics of a set of coins that can be updated one coin at a time: the
+ * MuHash of the coins, their count and amount. Used both for the change made
+ * by connecting or disconnecting a block, and, accumulated from the empty
+ * set, for the whole UTXO set.
+ */
+struct CCoinStatsDelta
+{
+    MuHash3072 muhash;
+    int64_t nTransactionOutputs{0};
+    CAmount nTotalAmount{0};
+    //! Value moved into the Sapling pool, which is not part of the coins
+    CAmount nShieldedAmount{0};
+
+    void AddCoin(const COutPoint& outpoint, const Coin& coin);
+    void SpendCoin(const COutPoint& outpoint, const Coin& coin);
+
+    CCoinStatsDelta& operator+=(const CCoinStatsDelta& other);
+
+    SERIALIZE_METHODS(CCoinStatsDelta, obj) { READWRITE(obj.muhash, obj.nTransactionOutputs, obj.nTotalAmount, obj.nShieldedAmount); }
+};
+
+/** UTXO set statistics as of a block, kept by the index for every connected block */
+struct CCoinStatsEntry
+{
+    int nHeight{0};
+    uint256 hashMuHash;
+    uint64_t nTransactionOutputs{0};
+    CAmount nTotalAmount{0};
+    CAmount nShieldedAmount{0};
+
+    SERIALIZE_METHODS(CCoinStatsEntry, obj) { READWRITE(obj.nHeight, obj.hashMuHash, obj.nTransactionOutputs, obj.nTotalAmount, obj.nShieldedAmount); }
+};
+
+/**
+ * Optional index (-coinstatsindex) of the UTXO set statistics of every
+ * connected block, so gettxoutsetinfo does not have to walk the coins
+ * database. The statistics of the current tip are kept in memory and updated
+ * with the change of each block connected or disconnected; they are written
+ * along with the coins on each full flush.
+ */
+class CCoinStatsIndex
+{
+public:
+    explicit CCoinStatsIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    /**
+     * Load the statistics of the coins database best block, or, when they were
+     * not flushed along with it (first start, unclean shutdown, reindex),
+     * compute them with a full scan of the coins and of the blocks.
+     */
+    bool Init(CCoinsView* coinsdb);
+
+    /** Apply the change of pindex, just connected on top of the tip */
+    void BlockConnected(const CBlockIndex* pindex, const CCoinStatsDelta& delta);
+
+    /** Apply the change undoing pindex, just disconnected from the tip */
+    void BlockDisconnected(const CBlockIndex* pindex, const CCoinStatsDelta& delta);
+
+    /** Write the statistics of the tip, once the coins are flushed */
+    bool Flush();
+
+    /** Statistics as of pindex, false if the block was never connected while the index was enabled */
+    bool LookUpStats(const CBlockIndex* pindex, CCoinStatsEntry& entry) const;
+
+    CAmount GetTotalAmount() const;
+
+private:
+    bool Rebuild(CCoinsView* coinsdb);
+    void WriteEntry() EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    CDBWrapper db;
+
+    mutable Mutex cs;
+    uint256 hashBestBlock GUARDED_BY(cs);
+    int nBestHeight GUARDED_BY(cs){0};
+    CCoinStatsDelta totals GUARDED_BY(cs);
+};
+
+extern std::unique_ptr<CCoinStatsIndex> g_coinStatsIndex;
+
+#endif // BCZ_COINSTATSINDEX_H
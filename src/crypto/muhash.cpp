@@ -0,0 +1,292 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "crypto/muhash.h"
+
+#include "crypto/chacha20.h"
+#include "crypto/common.h"
+#include "crypto/sha256.h"
+
+#include <assert.h>
+#include <limits>
+#include <string.h>
+
+namespace {
+
+using limb_t = Num3072::limb_t;
+using double_limb_t = Num3072::double_limb_t;
+constexpr int LIMB_SIZE = Num3072::LIMB_SIZE;
+constexpr int LIMBS = Num3072::LIMBS;
+/** 2^3072 - 1103717 is the largest 3072-bit safe prime number, is used as the order of the group. */
+constexpr limb_t MAX_PRIME_DIFF = 1103717;
+constexpr limb_t LIMB_MAX = std::numeric_limits<limb_t>::max();
+
+/** The prime modulus, as limbs */
+struct Modulus
+{
+    limb_t limbs[LIMBS];
+    Modulus()
+    {
+        limbs[0] = LIMB_MAX - (MAX_PRIME_DIFF - 1);
+        for (int i = 1; i < LIMBS; ++i) limbs[i] = LIMB_MAX;
+    }
+};
+const Modulus g_modulus;
+
+inline bool IsOne(const limb_t (&a)[LIMBS])
+{
+    if (a[0] != 1) return false;
+    for (int i = 1; i < LIMBS; ++i) {
+        if (a[i] != 0) return false;
+    }
+    return true;
+}
+
+inline bool IsEven(const limb_t (&a)[LIMBS]) { return (a[0] & 1) == 0; }
+
+/** a >= b */
+inline bool GreaterOrEqual(const limb_t (&a)[LIMBS], const limb_t (&b)[LIMBS])
+{
+    for (int i = LIMBS - 1; i >= 0; --i) {
+        if (a[i] != b[i]) return a[i] > b[i];
+    }
+    return true;
+}
+
+/** a += b, returning the carry out of the top limb */
+inline limb_t Add(limb_t (&a)[LIMBS], const limb_t (&b)[LIMBS])
+{
+    double_limb_t c = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        c += (double_limb_t)a[i] + b[i];
+        a[i] = (limb_t)c;
+        c >>= LIMB_SIZE;
+    }
+    return (limb_t)c;
+}
+
+/** a -= b, returning the borrow out of the top limb */
+inline limb_t Sub(limb_t (&a)[LIMBS], const limb_t (&b)[LIMBS])
+{
+    limb_t borrow = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        const limb_t bi = b[i] + borrow;
+        // b[i] + borrow only wraps when it is a full limb, which always borrows
+        const limb_t next = (bi < borrow) || (a[i] < bi);
+        a[i] -= bi;
+        borrow = next;
+    }
+    return borrow;
+}
+
+/** a = (a + (top << 3072)) >> 1 */
+inline void ShiftRight(limb_t (&a)[LIMBS], limb_t top)
+{
+    for (int i = 0; i < LIMBS - 1; ++i) {
+        a[i] = (a[i] >> 1) | (a[i + 1] << (LIMB_SIZE - 1));
+    }
+    a[LIMBS - 1] = (a[LIMBS - 1] >> 1) | (top << (LIMB_SIZE - 1));
+}
+
+/** a = a / 2 mod p, for a < p */
+inline void HalveMod(limb_t (&a)[LIMBS])
+{
+    limb_t top = 0;
+    if (!IsEven(a)) top = Add(a, g_modulus.limbs);
+    ShiftRight(a, top);
+}
+
+/** a = a - b mod p, for a, b < p */
+inline void SubMod(limb_t (&a)[LIMBS], const limb_t (&b)[LIMBS])
+{
+    // On a borrow a holds a - b + 2^3072, adding p wraps it back into [0, p)
+    if (Sub(a, b)) Add(a, g_modulus.limbs);
+}
+
+} // namespace
+
+bool Num3072::IsOverflow() const
+{
+    if (this->limbs[0] <= LIMB_MAX - MAX_PRIME_DIFF) return false;
+    for (int i = 1; i < LIMBS; ++i) {
+        if (this->limbs[i] != LIMB_MAX) return false;
+    }
+    return true;
+}
+
+void Num3072::FullReduce()
+{
+    // Subtracting p is adding MAX_PRIME_DIFF and dropping the carry out of 2^3072
+    double_limb_t c = MAX_PRIME_DIFF;
+    for (int i = 0; i < LIMBS; ++i) {
+        c += this->limbs[i];
+        this->limbs[i] = (limb_t)c;
+        c >>= LIMB_SIZE;
+    }
+}
+
+Num3072 Num3072::GetInverse() const
+{
+    // Binary extended Euclid on (a, p), keeping x1 * a = u and x2 * a = v (mod p).
+    // This is not constant time, which is fine as the inputs are public.
+    Num3072 u(*this);
+    if (u.IsOverflow()) u.FullReduce();
+    limb_t v[LIMBS];
+    memcpy(v, g_modulus.limbs, sizeof(v));
+    Num3072 x1;
+    limb_t x2[LIMBS] = {0};
+
+    while (!IsOne(u.limbs) && !IsOne(v)) {
+        while (IsEven(u.limbs)) {
+            ShiftRight(u.limbs, 0);
+            HalveMod(x1.limbs);
+        }
+        while (IsEven(v)) {
+            ShiftRight(v, 0);
+            HalveMod(x2);
+        }
+        if (GreaterOrEqual(u.limbs, v)) {
+            Sub(u.limbs, v);
+            SubMod(x1.limbs, x2);
+        } else {
+            Sub(v, u.limbs);
+            SubMod(x2, x1.limbs);
+        }
+    }
+    if (IsOne(u.limbs)) return x1;
+    memcpy(x1.limbs, x2, sizeof(x2));
+    return x1;
+}
+
+void Num3072::Multiply(const Num3072& a)
+{
+    // Schoolbook product into 6144 bits
+    limb_t prod[2 * LIMBS] = {0};
+    for (int i = 0; i < LIMBS; ++i) {
+        double_limb_t c = 0;
+        for (int j = 0; j < LIMBS; ++j) {
+            c += (double_limb_t)this->limbs[i] * a.limbs[j] + prod[i + j];
+            prod[i + j] = (limb_t)c;
+            c >>= LIMB_SIZE;
+        }
+        prod[i + LIMBS] = (limb_t)c;
+    }
+
+    // Fold the high half in, as 2^3072 = MAX_PRIME_DIFF (mod p)
+    double_limb_t c = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        c += (double_limb_t)prod[i + LIMBS] * MAX_PRIME_DIFF + prod[i];
+        this->limbs[i] = (limb_t)c;
+        c >>= LIMB_SIZE;
+    }
+    // The carry out is below 2^22: fold it once more, and a last time if that wraps
+    c *= MAX_PRIME_DIFF;
+    for (int i = 0; i < LIMBS; ++i) {
+        c += this->limbs[i];
+        this->limbs[i] = (limb_t)c;
+        c >>= LIMB_SIZE;
+    }
+    if (c) {
+        c = MAX_PRIME_DIFF;
+        for (int i = 0; i < LIMBS; ++i) {
+            c += this->limbs[i];
+            this->limbs[i] = (limb_t)c;
+            c >>= LIMB_SIZE;
+        }
+    }
+}
+
+void Num3072::SetToOne()
+{
+    this->limbs[0] = 1;
+    for (int i = 1; i < LIMBS; ++i) {
+        this->limbs[i] = 0;
+    }
+}
+
+void Num3072::Divide(const Num3072& a)
+{
+    if (this->IsOverflow()) this->FullReduce();
+
+    Num3072 inv = a.GetInverse();
+    this->Multiply(inv);
+    if (this->IsOverflow()) this->FullReduce();
+}
+
+Num3072::Num3072(const unsigned char (&data)[BYTE_SIZE])
+{
+    for (int i = 0; i < LIMBS; ++i) {
+        if (sizeof(limb_t) == 4) {
+            this->limbs[i] = ReadLE32(data + 4 * i);
+        } else if (sizeof(limb_t) == 8) {
+            this->limbs[i] = ReadLE64(data + 8 * i);
+        }
+    }
+}
+
+void Num3072::ToBytes(unsigned char (&out)[BYTE_SIZE])
+{
+    if (this->IsOverflow()) this->FullReduce();
+    for (int i = 0; i < LIMBS; ++i) {
+        if (sizeof(limb_t) == 4) {
+            WriteLE32(out + i * 4, this->limbs[i]);
+        } else if (sizeof(limb_t) == 8) {
+            WriteLE64(out + i * 8, this->limbs[i]);
+        }
+    }
+}
+
+Num3072 MuHash3072::ToNum3072(Span<const unsigned char> in)
+{
+    unsigned char tmp[Num3072::BYTE_SIZE];
+
+    uint256 hashed_in;
+    CSHA256().Write(in.data(), in.size()).Finalize(hashed_in.begin());
+    ChaCha20(hashed_in.begin(), hashed_in.size()).Keystream(tmp, Num3072::BYTE_SIZE);
+    Num3072 out{tmp};
+
+    return out;
+}
+
+MuHash3072::MuHash3072(Span<const unsigned char> in) noexcept
+{
+    m_numerator = ToNum3072(in);
+}
+
+void MuHash3072::Finalize(uint256& out) noexcept
+{
+    m_numerator.Divide(m_denominator);
+    m_denominator.SetToOne(); // Needed to keep the MuHash object valid
+
+    unsigned char data[Num3072::BYTE_SIZE];
+    m_numerator.ToBytes(data);
+
+    CSHA256().Write(data, sizeof(data)).Finalize(out.begin());
+}
+
+MuHash3072& MuHash3072::operator*=(const MuHash3072& mul) noexcept
+{
+    m_numerator.Multiply(mul.m_numerator);
+    m_denominator.Multiply(mul.m_denominator);
+    return *this;
+}
+
+MuHash3072& MuHash3072::operator/=(const MuHash3072& div) noexcept
+{
+    m_numerator.Multiply(div.m_denominator);
+    m_denominator.Multiply(div.m_numerator);
+    return *this;
+}
+
+MuHash3072& MuHash3072::Insert(Span<const unsigned char> in) noexcept
+{
+    m_numerator.Multiply(ToNum3072(in));
+    return *this;
+}
+
+MuHash3072& MuHash3072::Remove(Span<const unsigned char> in) noexcept
+{
+    m_denominator.Multiply(ToNum3072(in));
+    return *this;
+}
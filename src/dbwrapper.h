@@ -7,12 +7,16 @@
 
 #include "clientversion.h"
 #include "fs.h"
+#include "saltedhasher.h"
 #include "serialize.h"
 #include "streams.h"
 #include "util/system.h"
 #include "version.h"
 
+#include <algorithm>
 #include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
@@ -190,6 +194,11 @@ public:
         return piter->value().size();
     }
 
+    //! Raw access to the current entry, for copying it verbatim.
+    //! Only valid until the iterator is moved.
+    leveldb::Slice GetRawKey() { return piter->key(); }
+    leveldb::Slice GetRawValue() { return piter->value(); }
+
 };
 
 class CDBWrapper
@@ -380,6 +389,23 @@ public:
 
 };
 
+/** Hashing of serialized keys, for the in-memory maps keyed by them */
+struct DataStreamSaltedHasher
+{
+    std::size_t operator()(const CDataStream& s) const
+    {
+        return CSipHasher(StaticSaltedHasher::s.k0, StaticSaltedHasher::s.k1).Write((const unsigned char*)s.data(), s.size()).Finalize();
+    }
+};
+
+struct DataStreamEqual
+{
+    bool operator()(const CDataStream& a, const CDataStream& b) const
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+};
+
 template<typename CDBTransaction>
 class CDBTransactionIterator
 {
@@ -392,7 +418,9 @@ private:
     // At all times, only one of both provides the current value. The decision is made by comparing the current keys
     // of both iterators, so that always the smaller key is the current one. On Next(), the previously chosen iterator
     // is advanced.
-    typename CDBTransaction::WritesMap::iterator transactionIt;
+    // The transaction writes are not ordered: their keys are sorted on each seek
+    std::vector<const CDataStream*> transactionKeys;
+    size_t transactionPos{0};
     std::unique_ptr<ParentIterator> parentIt;
     CDataStream parentKey;
     bool curIsParent{false};
@@ -402,13 +430,13 @@ public:
             transaction(_transaction),
             parentKey(SER_DISK, CLIENT_VERSION)
     {
-        transactionIt = transaction.writes.end();
         parentIt = std::unique_ptr<ParentIterator>(transaction.parent.NewIterator());
     }
 
     void SeekToFirst()
     {
-        transactionIt = transaction.writes.begin();
+        SortTransactionKeys();
+        transactionPos = 0;
         parentIt->SeekToFirst();
         SkipDeletedAndOverwritten();
         DecideCur();
@@ -422,7 +450,11 @@ public:
 
     void Seek(const CDataStream& ssKey)
     {
-        transactionIt = transaction.writes.lower_bound(ssKey);
+        SortTransactionKeys();
+        transactionPos = std::lower_bound(transactionKeys.begin(), transactionKeys.end(), &ssKey,
+                                          [](const CDataStream* a, const CDataStream* b) {
+                                              return CDBTransaction::DataStreamCmp::less(*a, *b);
+                                          }) - transactionKeys.begin();
         parentIt->Seek(ssKey);
         SkipDeletedAndOverwritten();
         DecideCur();
@@ -430,12 +462,12 @@ public:
 
     bool Valid()
     {
-        return transactionIt != transaction.writes.end() || parentIt->Valid();
+        return TransactionValid() || parentIt->Valid();
     }
 
     void Next()
     {
-        if (transactionIt == transaction.writes.end() && !parentIt->Valid()) {
+        if (!TransactionValid() && !parentIt->Valid()) {
             return;
         }
         if (curIsParent) {
@@ -443,8 +475,8 @@ public:
             parentIt->Next();
             SkipDeletedAndOverwritten();
         } else {
-            assert(transactionIt != transaction.writes.end());
-            ++transactionIt;
+            assert(TransactionValid());
+            ++transactionPos;
         }
         DecideCur();
     }
@@ -461,7 +493,7 @@ public:
         } else {
             try {
                 // TODO try to avoid this copy (we need a stream that allows reading from external buffers)
-                CDataStream ssKey = transactionIt->first;
+                CDataStream ssKey = TransactionKey();
                 ssKey >> key;
             } catch (const std::exception&) {
                 return false;
@@ -478,7 +510,7 @@ public:
         if (curIsParent) {
             return parentIt->GetKey();
         } else {
-            return transactionIt->first;
+            return TransactionKey();
         }
     }
 
@@ -491,11 +523,33 @@ public:
         if (curIsParent) {
             return transaction.Read(parentKey, value);
         } else {
-            return transaction.Read(transactionIt->first, value);
+            return transaction.Read(TransactionKey(), value);
         }
     };
 
 private:
+    void SortTransactionKeys()
+    {
+        transactionKeys.clear();
+        transactionKeys.reserve(transaction.writes.size());
+        for (const auto& p : transaction.writes) {
+            transactionKeys.push_back(&p.first);
+        }
+        std::sort(transactionKeys.begin(), transactionKeys.end(), [](const CDataStream* a, const CDataStream* b) {
+            return CDBTransaction::DataStreamCmp::less(*a, *b);
+        });
+    }
+
+    bool TransactionValid() const
+    {
+        return transactionPos < transactionKeys.size();
+    }
+
+    const CDataStream& TransactionKey() const
+    {
+        return *transactionKeys[transactionPos];
+    }
+
     void SkipDeletedAndOverwritten()
     {
         while (parentIt->Valid()) {
@@ -509,12 +563,12 @@ private:
 
     void DecideCur()
     {
-        if (transactionIt != transaction.writes.end() && !parentIt->Valid()) {
+        if (TransactionValid() && !parentIt->Valid()) {
             curIsParent = false;
-        } else if (transactionIt == transaction.writes.end() && parentIt->Valid()) {
+        } else if (!TransactionValid() && parentIt->Valid()) {
             curIsParent = true;
-        } else if (transactionIt != transaction.writes.end() && parentIt->Valid()) {
-            if (CDBTransaction::DataStreamCmp::less(transactionIt->first, parentKey)) {
+        } else if (TransactionValid() && parentIt->Valid()) {
+            if (CDBTransaction::DataStreamCmp::less(TransactionKey(), parentKey)) {
                 curIsParent = false;
             } else {
                 curIsParent = true;
@@ -563,6 +617,17 @@ protected:
         V value;
     };
 
+    // Looked up on every read and write: hash maps of the serialized keys.
+    // The iterator sorts the written keys when it needs them in order.
+    typedef std::unordered_map<CDataStream, ValueHolderPtr, DataStreamSaltedHasher, DataStreamEqual> WritesMap;
+    typedef std::unordered_set<CDataStream, DataStreamSaltedHasher, DataStreamEqual> DeletesSet;
+
+    WritesMap writes;
+    DeletesSet deletes;
+
+public:
+    CDBTransaction(Parent &_parent, CommitTarget &_commitTarget) : parent(_parent), commitTarget(_commitTarget) {}
+
     template<typename K>
     static CDataStream KeyToDataStream(const K& key)
     {
@@ -572,15 +637,6 @@ protected:
         return ssKey;
     }
 
-    typedef std::map<CDataStream, ValueHolderPtr, DataStreamCmp> WritesMap;
-    typedef std::set<CDataStream, DataStreamCmp> DeletesSet;
-
-    WritesMap writes;
-    DeletesSet deletes;
-
-public:
-    CDBTransaction(Parent &_parent, CommitTarget &_commitTarget) : parent(_parent), commitTarget(_commitTarget) {}
-
     template <typename K, typename V>
     void Write(const K& key, const V& v)
     {
@@ -555,7 +555,7 @@ class CDeterministicMNManager
     static const int LIST_DIFFS_CACHE_SIZE = DISK_SNAPSHOT_PERIOD * DISK_SNAPSHOTS;
 
 public:
-    mutable RecursiveMutex cs;
+    mutable RecursiveMutex cs{"deterministicMNManager.cs"};
 
 private:
     CEvoDB& evoDb;
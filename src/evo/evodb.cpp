@@ -36,7 +36,8 @@ CEvoDB::CEvoDB(size_t nCacheSize, bool fMemory, bool fWipe) :
         db(fMemory ? "" : (GetDataDir() / "evodb"), nCacheSize, fMemory, fWipe),
         rootBatch(),
         rootDBTransaction(db, rootBatch),
-        curDBTransaction(rootDBTransaction, rootDBTransaction)
+        curDBTransaction(rootDBTransaction, rootDBTransaction),
+        readCache(EVODB_READ_CACHE_SIZE)
 {
 }
 
@@ -44,12 +45,18 @@ void CEvoDB::CommitCurTransaction()
 {
     LOCK(cs);
     curDBTransaction.Commit();
+    curTransactionKeys.clear();
 }
 
 void CEvoDB::RollbackCurTransaction()
 {
     LOCK(cs);
     curDBTransaction.Clear();
+    // The cached values of these keys may come from the discarded writes
+    for (const CDataStream& ssKey : curTransactionKeys) {
+        readCache.Erase(ssKey);
+    }
+    curTransactionKeys.clear();
 }
 
 bool CEvoDB::CommitRootTransaction()
@@ -61,6 +68,12 @@ bool CEvoDB::CommitRootTransaction()
     return ret;
 }
 
+void CEvoDB::ClearReadCache()
+{
+    LOCK(cs);
+    readCache.Clear();
+}
+
 bool CEvoDB::VerifyBestBlock(const uint256& hash)
 {
     uint256 hashBestBlock;
@@ -10,7 +10,11 @@
 #include "sync.h"
 #include "uint256.h"
 
+#include <list>
+
 static const std::string EVODB_BEST_BLOCK = "b_b";
+//! Number of decoded values kept by the evo db read cache
+static const size_t EVODB_READ_CACHE_SIZE = 4096;
 
 class CEvoDB;
 
@@ -28,6 +32,88 @@ public:
     void Rollback();
 };
 
+/**
+ * The values last read or written through CEvoDB, already deserialized, so that
+ * the objects looked up over and over while connecting blocks and running the
+ * DKG (quorum commitments, MN list diffs) are not read and decoded again each
+ * time. The least recently used values are evicted.
+ */
+class CEvoDBReadCache
+{
+private:
+    struct CachedValue {
+        virtual ~CachedValue() = default;
+    };
+    template <typename V>
+    struct CachedValueImpl : CachedValue {
+        explicit CachedValueImpl(const V& _value) : value(_value) {}
+        V value;
+    };
+
+    // Most recently used first
+    typedef std::list<std::pair<CDataStream, std::unique_ptr<CachedValue>>> EntryList;
+    EntryList entries;
+    std::unordered_map<CDataStream, EntryList::iterator, DataStreamSaltedHasher, DataStreamEqual> index;
+    const size_t nMaxSize;
+
+public:
+    explicit CEvoDBReadCache(size_t _nMaxSize) : nMaxSize(_nMaxSize) {}
+
+    template <typename V>
+    bool Get(const CDataStream& ssKey, V& value)
+    {
+        auto it = index.find(ssKey);
+        if (it == index.end()) {
+            return false;
+        }
+        // A key read back as another type is a miss
+        auto* impl = dynamic_cast<CachedValueImpl<V>*>(it->second->second.get());
+        if (!impl) {
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        value = impl->value;
+        return true;
+    }
+
+    bool Has(const CDataStream& ssKey) const
+    {
+        return index.count(ssKey) > 0;
+    }
+
+    template <typename V>
+    void Put(const CDataStream& ssKey, const V& value)
+    {
+        auto it = index.find(ssKey);
+        if (it != index.end()) {
+            it->second->second = std::make_unique<CachedValueImpl<V>>(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+        entries.emplace_front(ssKey, std::make_unique<CachedValueImpl<V>>(value));
+        index.emplace(ssKey, entries.begin());
+        if (entries.size() > nMaxSize) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+    void Erase(const CDataStream& ssKey)
+    {
+        auto it = index.find(ssKey);
+        if (it != index.end()) {
+            entries.erase(it->second);
+            index.erase(it);
+        }
+    }
+
+    void Clear()
+    {
+        index.clear();
+        entries.clear();
+    }
+};
+
 class CEvoDB
 {
 public:
@@ -43,6 +129,10 @@ private:
     RootTransaction rootDBTransaction;
     CurTransaction curDBTransaction;
 
+    CEvoDBReadCache readCache;
+    // Keys written or erased by the current transaction, evicted from the cache on rollback
+    std::unordered_set<CDataStream, DataStreamSaltedHasher, DataStreamEqual> curTransactionKeys;
+
 public:
     explicit CEvoDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
@@ -52,6 +142,7 @@ public:
         return std::make_unique<CEvoDBScopedCommitter>(*this);
     }
 
+    // Only for iterating: writes must go through Write/Erase, to keep the read cache in sync
     CurTransaction& GetCurTransaction()
     {
         AssertLockHeld(cs); // lock must be held from outside as long as the DB transaction is used
@@ -62,28 +153,43 @@ public:
     bool Read(const K& key, V& value)
     {
         LOCK(cs);
-        return curDBTransaction.Read(key, value);
+        const CDataStream ssKey = CurTransaction::KeyToDataStream(key);
+        if (readCache.Get(ssKey, value)) {
+            return true;
+        }
+        if (!curDBTransaction.Read(ssKey, value)) {
+            return false;
+        }
+        readCache.Put(ssKey, value);
+        return true;
     }
 
     template<typename K, typename V>
     void Write(const K& key, const V& value)
     {
         LOCK(cs);
-        curDBTransaction.Write(key, value);
+        const CDataStream ssKey = CurTransaction::KeyToDataStream(key);
+        curDBTransaction.Write(ssKey, value);
+        readCache.Put(ssKey, value);
+        curTransactionKeys.insert(ssKey);
     }
 
     template <typename K>
     bool Exists(const K& key)
     {
         LOCK(cs);
-        return curDBTransaction.Exists(key);
+        const CDataStream ssKey = CurTransaction::KeyToDataStream(key);
+        return readCache.Has(ssKey) || curDBTransaction.Exists(ssKey);
     }
 
     template <typename K>
     void Erase(const K& key)
     {
         LOCK(cs);
-        curDBTransaction.Erase(key);
+        const CDataStream ssKey = CurTransaction::KeyToDataStream(key);
+        curDBTransaction.Erase(ssKey);
+        readCache.Erase(ssKey);
+        curTransactionKeys.insert(ssKey);
     }
 
     CDBWrapper& GetRawDB()
@@ -98,6 +204,9 @@ public:
 
     bool CommitRootTransaction();
 
+    /** Drop the cached values, after writing to the raw db */
+    void ClearReadCache();
+
     bool VerifyBestBlock(const uint256& hash);
     void WriteBestBlock(const uint256& hash);
 
@@ -10,7 +10,11 @@
 #include "consensus/validation.h"
 #include "net.h" // for CSerializedNetMsg
 #include "netmessagemaker.h"
+#include "bls/bls_worker.h"
 #include "llmq/quorums_connections.h"
+#include "llmq/quorums_init.h"
+#include "net_processing.h" // for Misbehaving
+#include "shutdown.h"
 #include "tiertwo/masternode_meta_manager.h"
 #include "tiertwo/net_masternodes.h"
 #include "tiertwo/tiertwo_sync_state.h"
@@ -57,6 +61,85 @@ void CMNAuth::PushMNAUTH(CNode* pnode, CConnman& connman)
     connman.PushMessage(pnode, CNetMsgMaker(pnode->GetSendVersion()).Make(NetMsgType::MNAUTH, mnauth));
 }
 
+// Second half of MNAUTH processing, once the signature was found valid
+static void ProcessVerifiedMNAUTH(CNode* pnode, const CMNAuth& mnauth, const uint256& pubKeyHash, CConnman& connman)
+{
+    if (!pnode->fInbound) {
+        g_mmetaman.GetMetaInfo(mnauth.proRegTxHash)->SetLastOutboundSuccess(GetAdjustedTime());
+        if (pnode->m_masternode_probe_connection) {
+            LogPrint(BCLog::NET_MN, "%s -- Masternode probe successful for %s, disconnecting. peer=%d\n",
+                     __func__, mnauth.proRegTxHash.ToString(), pnode->GetId());
+            pnode->fDisconnect = true;
+            return;
+        }
+    }
+
+    // future: Move this to the first line of this function..
+    const CActiveMasternodeInfo* activeMnInfo{nullptr};
+    if (!fMasterNode || !activeMasternodeManager ||
+        (activeMnInfo = activeMasternodeManager->GetInfo())->proTxHash.IsNull()) {
+        return;
+    }
+
+    connman.ForEachNode([&](CNode* pnode2) {
+        if (pnode->fDisconnect) {
+            // we've already disconnected the new peer
+            return;
+        }
+
+        if (pnode2->verifiedProRegTxHash == mnauth.proRegTxHash) {
+            if (fMasterNode) {
+                auto deterministicOutbound = llmq::DeterministicOutboundConnection(activeMnInfo->proTxHash, mnauth.proRegTxHash);
+                LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- Masternode %s has already verified as peer %d, deterministicOutbound=%s. peer=%d\n",
+                         mnauth.proRegTxHash.ToString(), pnode2->GetId(), deterministicOutbound.ToString(), pnode->GetId());
+                if (deterministicOutbound == activeMnInfo->proTxHash) {
+                    if (pnode2->fInbound) {
+                        LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping old inbound, peer=%d\n", pnode2->GetId());
+                        pnode2->fDisconnect = true;
+                    } else if (pnode->fInbound) {
+                        LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping new inbound, peer=%d\n", pnode->GetId());
+                        pnode->fDisconnect = true;
+                    }
+                } else {
+                    if (!pnode2->fInbound) {
+                        LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping old outbound, peer=%d\n", pnode2->GetId());
+                        pnode2->fDisconnect = true;
+                    } else if (!pnode->fInbound) {
+                        LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping new outbound, peer=%d\n", pnode->GetId());
+                        pnode->fDisconnect = true;
+                    }
+                }
+            } else {
+                LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- Masternode %s has already verified as peer %d, dropping new connection. peer=%d\n",
+                         mnauth.proRegTxHash.ToString(), pnode2->GetId(), pnode->GetId());
+                pnode->fDisconnect = true;
+            }
+        }
+    });
+
+    if (pnode->fDisconnect) {
+        return;
+    }
+
+    {
+        LOCK(pnode->cs_mnauth);
+        pnode->verifiedProRegTxHash = mnauth.proRegTxHash;
+        pnode->verifiedPubKeyHash = pubKeyHash;
+    }
+
+    if (!pnode->m_masternode_iqr_connection && connman.GetTierTwoConnMan()->isMasternodeQuorumRelayMember(pnode->verifiedProRegTxHash)) {
+        // Tell our peer that we're interested in plain LLMQ recovered signatures.
+        // Otherwise, the peer would only announce/send messages resulting from QRECSIG,
+        // future e.g. tx locks or chainlocks. SPV and regular full nodes should not send
+        // this message as they are usually only interested in the higher level messages.
+        CNetMsgMaker msgMaker(pnode->GetSendVersion());
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::QSENDRECSIGS, true));
+        pnode->m_masternode_iqr_connection = true;
+    }
+
+    LogPrint(BCLog::NET_MN, "CMNAuth::%s -- Valid MNAUTH for %s, peer=%d\n", __func__, mnauth.proRegTxHash.ToString(), pnode->GetId());
+}
+
 bool CMNAuth::ProcessMessage(CNode* pnode, const std::string& strCommand, CDataStream& vRecv, CConnman& connman, CValidationState& state)
 {
     if (!g_tiertwo_sync_state.IsBlockchainSynced()) {
@@ -68,7 +151,7 @@ bool CMNAuth::ProcessMessage(CNode* pnode, const std::string& strCommand, CDataS
         CMNAuth mnauth;
         vRecv >> mnauth;
         // only one MNAUTH allowed
-        bool fAlreadyHaveMNAUTH = WITH_LOCK(pnode->cs_mnauth, return !pnode->verifiedProRegTxHash.IsNull(););
+        bool fAlreadyHaveMNAUTH = pnode->fMNAuthPending || WITH_LOCK(pnode->cs_mnauth, return !pnode->verifiedProRegTxHash.IsNull(););
         if (fAlreadyHaveMNAUTH) {
             return state.DoS(100, false, REJECT_INVALID, "duplicate mnauth");
         }
@@ -111,86 +194,44 @@ bool CMNAuth::ProcessMessage(CNode* pnode, const std::string& strCommand, CDataS
             LogPrint(BCLog::NET_MN, "CMNAuth::%s -- constructed signHash for nVersion %d, peer=%d\n", __func__, pnode->nVersion, pnode->GetId());
         }
 
-        if (!mnauth.sig.VerifyInsecure(dmn->pdmnState->pubKeyOperator.Get(), signHash)) {
-            // Same as above, MN seems to not know its fate yet, so give it a chance to update. If this is a
-            // malicious node (DoSing us), it'll get banned soon.
-            return state.DoS(10, false, REJECT_INVALID, "mnauth signature verification failed");
-        }
+        const CBLSPublicKey pubKeyOperator = dmn->pdmnState->pubKeyOperator.Get();
+        const uint256 pubKeyHash = dmn->pdmnState->pubKeyOperator.GetHash();
 
-        if (!pnode->fInbound) {
-            g_mmetaman.GetMetaInfo(mnauth.proRegTxHash)->SetLastOutboundSuccess(GetAdjustedTime());
-            if (pnode->m_masternode_probe_connection) {
-                LogPrint(BCLog::NET_MN, "%s -- Masternode probe successful for %s, disconnecting. peer=%d\n",
-                         __func__, mnauth.proRegTxHash.ToString(), pnode->GetId());
-                pnode->fDisconnect = true;
-                return true;
+        if (!llmq::blsWorker || !llmq::blsWorker->IsRunning()) {
+            // No BLS worker threads (DKG disabled): verify here
+            if (!mnauth.sig.VerifyInsecure(pubKeyOperator, signHash)) {
+                // Same as above, MN seems to not know its fate yet, so give it a chance to update. If this is a
+                // malicious node (DoSing us), it'll get banned soon.
+                return state.DoS(10, false, REJECT_INVALID, "mnauth signature verification failed");
             }
-        }
-
-        // future: Move this to the first line of this function..
-        const CActiveMasternodeInfo* activeMnInfo{nullptr};
-        if (!fMasterNode || !activeMasternodeManager ||
-            (activeMnInfo = activeMasternodeManager->GetInfo())->proTxHash.IsNull()) {
+            ProcessVerifiedMNAUTH(pnode, mnauth, pubKeyHash, connman);
             return true;
         }
 
-        connman.ForEachNode([&](CNode* pnode2) {
-            if (pnode->fDisconnect) {
-                // we've already disconnected the new peer
-                return;
+        // Queue the signature on the BLS worker, which verifies the MNAUTHs of many peers in one aggregated
+        // check. The peer's following messages are held back until the result is in.
+        pnode->fMNAuthPending = true;
+        const NodeId nodeId = pnode->GetId();
+        CConnman* pconnman = &connman;
+        llmq::blsWorker->AsyncVerifySig(mnauth.sig, pubKeyOperator, signHash, [nodeId, mnauth, pubKeyHash, pconnman](bool fValid) {
+            if (!fValid) {
+                // Same as above, MN seems to not know its fate yet, so give it a chance to update
+                LOCK(cs_main);
+                Misbehaving(nodeId, 10, "mnauth signature verification failed");
+            } else {
+                // The operator key may have changed while the signature was queued
+                auto dmnTip = deterministicMNManager->GetListAtChainTip().GetMN(mnauth.proRegTxHash);
+                fValid = dmnTip && dmnTip->pdmnState->pubKeyOperator.GetHash() == pubKeyHash;
             }
-
-            if (pnode2->verifiedProRegTxHash == mnauth.proRegTxHash) {
-                if (fMasterNode) {
-                    auto deterministicOutbound = llmq::DeterministicOutboundConnection(activeMnInfo->proTxHash, mnauth.proRegTxHash);
-                    LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- Masternode %s has already verified as peer %d, deterministicOutbound=%s. peer=%d\n",
-                             mnauth.proRegTxHash.ToString(), pnode2->GetId(), deterministicOutbound.ToString(), pnode->GetId());
-                    if (deterministicOutbound == activeMnInfo->proTxHash) {
-                        if (pnode2->fInbound) {
-                            LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping old inbound, peer=%d\n", pnode2->GetId());
-                            pnode2->fDisconnect = true;
-                        } else if (pnode->fInbound) {
-                            LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping new inbound, peer=%d\n", pnode->GetId());
-                            pnode->fDisconnect = true;
-                        }
-                    } else {
-                        if (!pnode2->fInbound) {
-                            LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping old outbound, peer=%d\n", pnode2->GetId());
-                            pnode2->fDisconnect = true;
-                        } else if (!pnode->fInbound) {
-                            LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- dropping new outbound, peer=%d\n", pnode->GetId());
-                            pnode->fDisconnect = true;
-                        }
-                    }
-                } else {
-                    LogPrint(BCLog::NET_MN, "CMNAuth::ProcessMessage -- Masternode %s has already verified as peer %d, dropping new connection. peer=%d\n",
-                             mnauth.proRegTxHash.ToString(), pnode2->GetId(), pnode->GetId());
-                    pnode->fDisconnect = true;
+            pconnman->ForNode(nodeId, [&](CNode* pnode2) {
+                if (fValid) {
+                    ProcessVerifiedMNAUTH(pnode2, mnauth, pubKeyHash, *pconnman);
                 }
-            }
-        });
-
-        if (pnode->fDisconnect) {
-            return true;
-        }
-
-        {
-            LOCK(pnode->cs_mnauth);
-            pnode->verifiedProRegTxHash = mnauth.proRegTxHash;
-            pnode->verifiedPubKeyHash = dmn->pdmnState->pubKeyOperator.GetHash();
-        }
-
-        if (!pnode->m_masternode_iqr_connection && connman.GetTierTwoConnMan()->isMasternodeQuorumRelayMember(pnode->verifiedProRegTxHash)) {
-            // Tell our peer that we're interested in plain LLMQ recovered signatures.
-            // Otherwise, the peer would only announce/send messages resulting from QRECSIG,
-            // future e.g. tx locks or chainlocks. SPV and regular full nodes should not send
-            // this message as they are usually only interested in the higher level messages.
-            CNetMsgMaker msgMaker(pnode->GetSendVersion());
-            connman.PushMessage(pnode, msgMaker.Make(NetMsgType::QSENDRECSIGS, true));
-            pnode->m_masternode_iqr_connection = true;
-        }
-
-        LogPrint(BCLog::NET_MN, "CMNAuth::%s -- Valid MNAUTH for %s, peer=%d\n", __func__, mnauth.proRegTxHash.ToString(), pnode->GetId());
+                pnode2->fMNAuthPending = false;
+                return true;
+            });
+            pconnman->WakeMessageHandler();
+        }, [] { return ShutdownRequested(); });
     }
     return true;
 }
@@ -6,6 +6,7 @@
 #include "evo/specialtx_validation.h"
 
 #include "chain.h"
+#include "checkqueue.h"
 #include "coins.h"
 #include "chainparams.h"
 #include "clientversion.h"
@@ -14,10 +15,43 @@
 #include "evo/providertx.h"
 #include "llmq/quorums_blockprocessor.h"
 #include "messagesigner.h"
+#include "optional.h"
 #include "primitives/transaction.h"
 #include "primitives/block.h"
 #include "script/standard.h"
 #include "spork.h"
+#include "util/threadnames.h"
+
+static CCheckQueue<CSpecialTxCheckJob> specialtxcheckqueue(16);
+
+void ThreadSpecialTxCheck()
+{
+    util::ThreadRename("bcz-protxch");
+    specialtxcheckqueue.Thread();
+}
+
+bool RunSpecialTxCheckJobs(std::vector<CSpecialTxCheckJob>& vJobs)
+{
+    CCheckQueueControl<CSpecialTxCheckJob> control(&specialtxcheckqueue);
+    control.Add(vJobs);
+    return control.Wait();
+}
+
+bool CSpecialTxSigCheck::Verify(std::string& strError) const
+{
+    switch (kind) {
+        case HASH_ECDSA:
+            return CHashSigner::VerifyHash(hash, keyID, vchSig, strError);
+        case STRING_ECDSA:
+            return CMessageSigner::VerifyMessage(keyID, vchSig, strMessage, strError);
+        case HASH_BLS:
+            return sig.VerifyInsecure(pubKey, hash);
+        case NONE:
+            break;
+    }
+    strError = "no signature to check";
+    return false;
+}
 
 /* -- Helper static functions -- */
 
@@ -48,33 +82,36 @@ static bool CheckService(const CService& addr, CValidationState& state)
     return true;
 }
 
-template <typename Payload>
-static bool CheckHashSig(const Payload& pl, const CKeyID& keyID, CValidationState& state)
+// Verify the signature now, or queue the check when pvChecks is given
+static bool RunOrDeferSigCheck(CSpecialTxSigCheck&& check, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
+    if (pvChecks) {
+        pvChecks->push_back(std::move(check));
+        return true;
+    }
     std::string strError;
-    if (!CHashSigner::VerifyHash(::SerializeHash(pl), keyID, pl.vchSig, strError)) {
+    if (!check.Verify(strError)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig", false, strError);
     }
     return true;
 }
 
 template <typename Payload>
-static bool CheckHashSig(const Payload& pl, const CBLSPublicKey& pubKey, CValidationState& state)
+static bool CheckHashSig(const Payload& pl, const CKeyID& keyID, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
-    if (!pl.sig.VerifyInsecure(pubKey, ::SerializeHash(pl))) {
-        return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig", false);
-    }
-    return true;
+    return RunOrDeferSigCheck(CSpecialTxSigCheck(::SerializeHash(pl), keyID, pl.vchSig), state, pvChecks);
 }
 
 template <typename Payload>
-static bool CheckStringSig(const Payload& pl, const CKeyID& keyID, CValidationState& state)
+static bool CheckHashSig(const Payload& pl, const CBLSPublicKey& pubKey, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
-    std::string strError;
-    if (!CMessageSigner::VerifyMessage(keyID, pl.vchSig, pl.MakeSignString(), strError)) {
-        return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig", false, strError);
-    }
-    return true;
+    return RunOrDeferSigCheck(CSpecialTxSigCheck(::SerializeHash(pl), pubKey, pl.sig), state, pvChecks);
+}
+
+template <typename Payload>
+static bool CheckStringSig(const Payload& pl, const CKeyID& keyID, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
+{
+    return RunOrDeferSigCheck(CSpecialTxSigCheck(pl.MakeSignString(), keyID, pl.vchSig), state, pvChecks);
 }
 
 template <typename Payload>
@@ -106,7 +143,7 @@ static bool CheckCollateralOut(const CTxOut& out, const ProRegPL& pl, CValidatio
 }
 
 // Provider Register Payload
-static bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const CCoinsViewCache* view, CValidationState& state)
+static bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const CDeterministicMNList* mnList, const CCoinsViewCache* view, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
     assert(tx.nType == CTransaction::TxType::PROREG);
 
@@ -198,7 +235,7 @@ static bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev,
             return state.DoS(10, false, REJECT_INVALID, "bad-protx-collateral-pkh");
         }
         // collateral is not part of this ProRegTx, so we must verify ownership of the collateral
-        if (!CheckStringSig(pl, *keyForPayloadSig, state)) {
+        if (!CheckStringSig(pl, *keyForPayloadSig, state, pvChecks)) {
             // pass the state returned by the function above
             return false;
         }
@@ -208,17 +245,16 @@ static bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev,
         return false;
     }
 
-    if (pindexPrev) {
-        auto mnList = deterministicMNManager->GetListForBlock(pindexPrev);
+    if (mnList) {
         // only allow reusing of addresses when it's for the same collateral (which replaces the old MN)
-        if (mnList.HasUniqueProperty(pl.addr) && mnList.GetUniquePropertyMN(pl.addr)->collateralOutpoint != pl.collateralOutpoint) {
+        if (mnList->HasUniqueProperty(pl.addr) && mnList->GetUniquePropertyMN(pl.addr)->collateralOutpoint != pl.collateralOutpoint) {
             return state.DoS(10, false, REJECT_DUPLICATE, "bad-protx-dup-IP-address");
         }
         // never allow duplicate keys, even if this ProTx would replace an existing MN
-        if (mnList.HasUniqueProperty(pl.keyIDOwner)) {
+        if (mnList->HasUniqueProperty(pl.keyIDOwner)) {
             return state.DoS(10, false, REJECT_DUPLICATE, "bad-protx-dup-owner-key");
         }
-        if (mnList.HasUniqueProperty(pl.pubKeyOperator)) {
+        if (mnList->HasUniqueProperty(pl.pubKeyOperator)) {
             return state.DoS(10, false, REJECT_DUPLICATE, "bad-protx-dup-operator-key");
         }
     }
@@ -227,7 +263,7 @@ static bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev,
 }
 
 // Provider Update Service Payload
-static bool CheckProUpServTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state)
+static bool CheckProUpServTx(const CTransaction& tx, const CDeterministicMNList* mnList, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
     assert(tx.nType == CTransaction::TxType::PROUPSERV);
 
@@ -250,15 +286,14 @@ static bool CheckProUpServTx(const CTransaction& tx, const CBlockIndex* pindexPr
         return false;
     }
 
-    if (pindexPrev) {
-        auto mnList = deterministicMNManager->GetListForBlock(pindexPrev);
-        auto mn = mnList.GetMN(pl.proTxHash);
+    if (mnList) {
+        auto mn = mnList->GetMN(pl.proTxHash);
         if (!mn) {
             return state.DoS(100, false, REJECT_INVALID, "bad-protx-hash");
         }
 
         // don't allow updating to addresses already used by other MNs
-        if (mnList.HasUniqueProperty(pl.addr) && mnList.GetUniquePropertyMN(pl.addr)->proTxHash != pl.proTxHash) {
+        if (mnList->HasUniqueProperty(pl.addr) && mnList->GetUniquePropertyMN(pl.addr)->proTxHash != pl.proTxHash) {
             return state.DoS(10, false, REJECT_DUPLICATE, "bad-protx-dup-addr");
         }
 
@@ -273,8 +308,8 @@ static bool CheckProUpServTx(const CTransaction& tx, const CBlockIndex* pindexPr
             }
         }
 
-        // we can only check the signature if pindexPrev != nullptr and the MN is known
-        if (!CheckHashSig(pl, mn->pdmnState->pubKeyOperator.Get(), state)) {
+        // we can only check the signature if the list at pindexPrev is given and the MN is known
+        if (!CheckHashSig(pl, mn->pdmnState->pubKeyOperator.Get(), state, pvChecks)) {
             // pass the state returned by the function above
             return false;
         }
@@ -284,7 +319,7 @@ static bool CheckProUpServTx(const CTransaction& tx, const CBlockIndex* pindexPr
 }
 
 // Provider Update Registrar Payload
-static bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const CCoinsViewCache* view, CValidationState& state)
+static bool CheckProUpRegTx(const CTransaction& tx, const CDeterministicMNList* mnList, const CCoinsViewCache* view, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
     assert(tx.nType == CTransaction::TxType::PROUPREG);
 
@@ -326,11 +361,10 @@ static bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPre
         return false;
     }
 
-    if (pindexPrev) {
+    if (mnList) {
         assert(view != nullptr);
 
-        auto mnList = deterministicMNManager->GetListForBlock(pindexPrev);
-        auto dmn = mnList.GetMN(pl.proTxHash);
+        auto dmn = mnList->GetMN(pl.proTxHash);
         if (!dmn) {
             return state.DoS(100, false, REJECT_INVALID, "bad-protx-hash");
         }
@@ -356,14 +390,14 @@ static bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPre
             return state.DoS(10, false, REJECT_INVALID, "bad-protx-collateral-reuse");
         }
 
-        if (mnList.HasUniqueProperty(pl.pubKeyOperator)) {
-            auto otherDmn = mnList.GetUniquePropertyMN(pl.pubKeyOperator);
+        if (mnList->HasUniqueProperty(pl.pubKeyOperator)) {
+            auto otherDmn = mnList->GetUniquePropertyMN(pl.pubKeyOperator);
             if (pl.proTxHash != otherDmn->proTxHash) {
                 return state.DoS(10, false, REJECT_DUPLICATE, "bad-protx-dup-key");
             }
         }
 
-        if (!CheckHashSig(pl, dmn->pdmnState->keyIDOwner, state)) {
+        if (!CheckHashSig(pl, dmn->pdmnState->keyIDOwner, state, pvChecks)) {
             // pass the state returned by the function above
             return false;
         }
@@ -374,7 +408,7 @@ static bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPre
 }
 
 // Provider Update Revoke Payload
-static bool CheckProUpRevTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state)
+static bool CheckProUpRevTx(const CTransaction& tx, const CDeterministicMNList* mnList, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks)
 {
     assert(tx.nType == CTransaction::TxType::PROUPREV);
 
@@ -398,13 +432,12 @@ static bool CheckProUpRevTx(const CTransaction& tx, const CBlockIndex* pindexPre
         return false;
     }
 
-    if (pindexPrev) {
-        auto mnList = deterministicMNManager->GetListForBlock(pindexPrev);
-        auto dmn = mnList.GetMN(pl.proTxHash);
+    if (mnList) {
+        auto dmn = mnList->GetMN(pl.proTxHash);
         if (!dmn)
             return state.DoS(100, false, REJECT_INVALID, "bad-protx-hash");
 
-        if (!CheckHashSig(pl, dmn->pdmnState->pubKeyOperator.Get(), state)) {
+        if (!CheckHashSig(pl, dmn->pdmnState->pubKeyOperator.Get(), state, pvChecks)) {
             // pass the state returned by the function above
             return false;
         }
@@ -542,11 +575,16 @@ static bool CheckSpecialTxBasic(const CTransaction& tx, CValidationState& state)
     return true;
 }
 
-// contextual and non-contextual per-type checks
-// - pindexPrev=null: CheckBlock-->CheckSpecialTxNoContext
-// - pindexPrev=chainActive.Tip: AcceptToMemoryPoolWorker-->CheckSpecialTx
-// - pindexPrev=pindex->pprev: ConnectBlock-->ProcessSpecialTxsInBlock-->CheckSpecialTx
-bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const CCoinsViewCache* view, CValidationState& state)
+static bool IsProTxType(int16_t nType)
+{
+    return nType == CTransaction::TxType::PROREG || nType == CTransaction::TxType::PROUPSERV ||
+           nType == CTransaction::TxType::PROUPREG || nType == CTransaction::TxType::PROUPREV;
+}
+
+// contextual and non-contextual per-type checks, against mnList (the list at pindexPrev, or null without context).
+// ProTx signature checks are appended to pvChecks instead of being verified, when it is not null.
+static bool CheckSpecialTxInternal(const CTransaction& tx, const CBlockIndex* pindexPrev, const CDeterministicMNList* mnList,
+                                   const CCoinsViewCache* view, CValidationState& state, std::vector<CSpecialTxSigCheck>* pvChecks) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     AssertLockHeld(cs_main);
 
@@ -563,19 +601,19 @@ bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const
         }
         case CTransaction::TxType::PROREG: {
             // provider-register
-            return CheckProRegTx(tx, pindexPrev, view, state);
+            return CheckProRegTx(tx, pindexPrev, mnList, view, state, pvChecks);
         }
         case CTransaction::TxType::PROUPSERV: {
             // provider-update-service
-            return CheckProUpServTx(tx, pindexPrev, state);
+            return CheckProUpServTx(tx, mnList, state, pvChecks);
         }
         case CTransaction::TxType::PROUPREG: {
             // provider-update-registrar
-            return CheckProUpRegTx(tx, pindexPrev, view, state);
+            return CheckProUpRegTx(tx, mnList, view, state, pvChecks);
         }
         case CTransaction::TxType::PROUPREV: {
             // provider-update-revoke
-            return CheckProUpRevTx(tx, pindexPrev, state);
+            return CheckProUpRevTx(tx, mnList, state, pvChecks);
         }
         case CTransaction::TxType::LLMQCOMM: {
             // quorum commitment
@@ -587,9 +625,23 @@ bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const
                      REJECT_INVALID, "bad-tx-type");
 }
 
+// - pindexPrev=null: CheckBlock-->CheckSpecialTxNoContext
+// - pindexPrev=chainActive.Tip: AcceptToMemoryPoolWorker-->CheckSpecialTx
+// - pindexPrev=pindex->pprev: ConnectBlock-->ProcessSpecialTxsInBlock-->CheckSpecialTxInternal
+bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, const CCoinsViewCache* view, CValidationState& state)
+{
+    AssertLockHeld(cs_main);
+
+    Optional<CDeterministicMNList> mnList;
+    if (pindexPrev && IsProTxType(tx.nType)) {
+        mnList = deterministicMNManager->GetListForBlock(pindexPrev);
+    }
+    return CheckSpecialTxInternal(tx, pindexPrev, mnList.get_ptr(), view, state, nullptr);
+}
+
 bool CheckSpecialTxNoContext(const CTransaction& tx, CValidationState& state)
 {
-    return CheckSpecialTx(tx, nullptr, nullptr, state);
+    return CheckSpecialTxInternal(tx, nullptr, nullptr, nullptr, state, nullptr);
 }
 
 
@@ -597,14 +649,48 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, co
 {
     AssertLockHeld(cs_main);
 
-    // check special txes
+    // The list at the parent block is the same for every ProTx of the block: fetch it once
+    Optional<CDeterministicMNList> mnList;
+    for (const CTransactionRef& tx : block.vtx) {
+        if (IsProTxType(tx->nType)) {
+            mnList = deterministicMNManager->GetListForBlock(pindex->pprev);
+            break;
+        }
+    }
+
+    // check special txes, collecting their signature checks
+    std::vector<CSpecialTxSigCheck> vChecks;
     for (const CTransactionRef& tx: block.vtx) {
-        if (!CheckSpecialTx(*tx, pindex->pprev, view, state)) {
+        if (!CheckSpecialTxInternal(*tx, pindex->pprev, mnList.get_ptr(), view, state, &vChecks)) {
             // pass the state returned by the function above
             return false;
         }
     }
 
+    // verify the signatures on the check threads, or here when there are none
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        std::vector<CSpecialTxCheckJob> vJobs;
+        vJobs.reserve(vChecks.size());
+        for (const CSpecialTxSigCheck& check : vChecks) {
+            const CSpecialTxSigCheck* pcheck = &check;
+            vJobs.emplace_back([pcheck]{
+                std::string strError;
+                return pcheck->Verify(strError);
+            });
+        }
+        if (!RunSpecialTxCheckJobs(vJobs)) {
+            return state.DoS(100, error("%s: ProTx signature check failed in block %s", __func__, block.GetHash().ToString()),
+                             REJECT_INVALID, "bad-protx-sig");
+        }
+    } else {
+        for (const CSpecialTxSigCheck& check : vChecks) {
+            std::string strError;
+            if (!check.Verify(strError)) {
+                return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig", false, strError);
+            }
+        }
+    }
+
     if (!llmq::quorumBlockProcessor->ProcessBlock(block, pindex, state, fJustCheck)) {
         // pass the state returned by the function above
         return false;
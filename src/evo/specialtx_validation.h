@@ -6,10 +6,14 @@
 #ifndef BCZ_SPECIALTX_H
 #define BCZ_SPECIALTX_H
 
+#include "bls/bls_wrapper.h"
 #include "llmq/quorums_commitment.h"
+#include "pubkey.h"
 #include "validation.h" // cs_main needed by CheckLLMQCommitment (!TODO: remove)
 #include "version.h"
 
+#include <functional>
+
 class CBlock;
 class CBlockIndex;
 class CCoinsViewCache;
@@ -20,6 +24,66 @@ class uint256;
 /** The maximum allowed size of the extraPayload (for any TxType) */
 static const unsigned int MAX_SPECIALTX_EXTRAPAYLOAD = 10000;
 
+/**
+ * Signature check of a ProTx payload (ECDSA over the payload hash or sign string,
+ * or BLS over the payload hash), deferred by ProcessSpecialTxsInBlock so that the
+ * checks of a whole block run on the special tx check threads.
+ */
+class CSpecialTxSigCheck
+{
+public:
+    CSpecialTxSigCheck() {}
+    CSpecialTxSigCheck(const uint256& hashIn, const CKeyID& keyIDIn, const std::vector<unsigned char>& vchSigIn) :
+        kind(HASH_ECDSA), hash(hashIn), keyID(keyIDIn), vchSig(vchSigIn) {}
+    CSpecialTxSigCheck(const std::string& strMessageIn, const CKeyID& keyIDIn, const std::vector<unsigned char>& vchSigIn) :
+        kind(STRING_ECDSA), strMessage(strMessageIn), keyID(keyIDIn), vchSig(vchSigIn) {}
+    CSpecialTxSigCheck(const uint256& hashIn, const CBLSPublicKey& pubKeyIn, const CBLSSignature& sigIn) :
+        kind(HASH_BLS), hash(hashIn), pubKey(pubKeyIn), sig(sigIn) {}
+
+    bool Verify(std::string& strError) const;
+
+private:
+    enum Kind : uint8_t {
+        NONE,
+        HASH_ECDSA,
+        STRING_ECDSA,
+        HASH_BLS,
+    };
+
+    Kind kind{NONE};
+    uint256 hash;
+    std::string strMessage;
+    CKeyID keyID;
+    std::vector<unsigned char> vchSig;
+    CBLSPublicKey pubKey;
+    CBLSSignature sig;
+};
+
+/**
+ * Job of the special tx check threads. They are idle outside of
+ * ProcessSpecialTxsInBlock, so other per-block work that needs no lock (the
+ * block input prefetch of ConnectTip) runs on them as well.
+ */
+class CSpecialTxCheckJob
+{
+public:
+    CSpecialTxCheckJob() {}
+    explicit CSpecialTxCheckJob(std::function<bool()> fnIn) : fn(std::move(fnIn)) {}
+
+    bool operator()() { return fn(); }
+
+    void swap(CSpecialTxCheckJob& job) { fn.swap(job.fn); }
+
+private:
+    std::function<bool()> fn;
+};
+
+/** Run the jobs on the special tx check threads and wait for them. False if any of them failed. */
+bool RunSpecialTxCheckJobs(std::vector<CSpecialTxCheckJob>& vJobs);
+
+/** Run a special tx check thread */
+void ThreadSpecialTxCheck();
+
 /** Payload validity checks (including duplicate unique properties against list at pindexPrev)*/
 // Note: for +v2, if the tx is not a special tx, this method returns true.
 // Note2: This function only performs extra payload related checks, it does NOT checks regular inputs and outputs.
@@ -20,7 +20,11 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <signal.h>
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <memory>
+#include <mutex>
 
 #include <event2/thread.h>
 #include <event2/buffer.h>
@@ -535,6 +539,9 @@ HTTPRequest::~HTTPRequest()
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL, "Unhandled request");
+    } else if (req) {
+        // Chunked reply left open, e.g. by an exception in the handler
+        AbortReplyChunked();
     }
     // evhttpd cleans up the request, as long as a reply was sent.
 }
@@ -582,6 +589,20 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
  * Replies must be sent in the main loop in the main http thread,
  * this cannot be done from worker threads.
  */
+/** Re-enable reading from the socket. This is the second part of the libevent workaround in http_request_cb. */
+static void ReenableReading(struct evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
 void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
 {
     assert(!replySent && req);
@@ -592,20 +613,122 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
+        ReenableReading(req_copy);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = 0; // transferred back to main thread
+}
+
+/** Output side of a chunked reply, updated by the events that send it */
+struct HTTPChunkedReply
+{
+    std::mutex cs;
+    std::condition_variable cond;
+    //! Bytes handed to events that have not run yet
+    size_t nQueued{0};
+    //! Bytes in the connection output buffer, as of the last event
+    size_t nBuffered{0};
+    bool fProbePending{false};
+    //! The client went away
+    bool fClosed{false};
+};
+
+/** Measure what the connection of req still has to send. Event thread only. */
+static void UpdateChunkedReply(struct evhttp_request* req, HTTPChunkedReply& state)
+{
+    evhttp_connection* conn = evhttp_request_get_connection(req);
+    bufferevent* bev = conn ? evhttp_connection_get_bufferevent(conn) : nullptr;
+    std::lock_guard<std::mutex> lock(state.cs);
+    state.fClosed = !bev;
+    state.nBuffered = bev ? evbuffer_get_length(bufferevent_get_output(bev)) : 0;
+    state.cond.notify_all();
+}
+
+void HTTPRequest::StartReplyChunked(int nStatus)
+{
+    assert(!replySent && req);
+    chunked = std::make_shared<HTTPChunkedReply>();
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+}
+
+void HTTPRequest::WriteReplyChunk(std::string&& strChunk)
+{
+    assert(replySent && req && chunked);
+    if (strChunk.empty()) return; // an empty chunk would terminate the reply
+    auto req_copy = req;
+    auto state = chunked;
+    {
+        // Backpressure: wait for the client to take what is already queued. The
+        // buffer is measured by the event thread, ask it again until it drains;
+        // a stalled client is dropped by the server timeout, which ends the wait.
+        std::unique_lock<std::mutex> lock(state->cs);
+        while (!state->fClosed && state->nQueued + state->nBuffered > MAX_HTTP_CHUNKED_BUFFERED) {
+            if (!state->fProbePending) {
+                state->fProbePending = true;
+                HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, state]{
+                    {
+                        std::lock_guard<std::mutex> probeLock(state->cs);
+                        state->fProbePending = false;
+                    }
+                    UpdateChunkedReply(req_copy, *state);
+                });
+                ev->trigger(nullptr);
             }
+            state->cond.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        if (state->fClosed) return;
+        state->nQueued += strChunk.size();
+    }
+
+    // Events are handled in the order they are triggered, so chunks go out in order
+    auto chunk = std::make_shared<std::string>(std::move(strChunk));
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, state, chunk]{
+        struct evbuffer* evb = evbuffer_new();
+        evbuffer_add(evb, chunk->data(), chunk->size());
+        evhttp_send_reply_chunk(req_copy, evb);
+        evbuffer_free(evb);
+        {
+            std::lock_guard<std::mutex> lock(state->cs);
+            state->nQueued -= chunk->size();
+        }
+        UpdateChunkedReply(req_copy, *state);
+    });
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::EndReplyChunked()
+{
+    assert(replySent && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy]{
+        evhttp_send_reply_end(req_copy);
+        ReenableReading(req_copy);
+    });
+    ev->trigger(nullptr);
+    req = 0; // transferred back to main thread
+}
+
+void HTTPRequest::AbortReplyChunked()
+{
+    assert(replySent && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy]{
+        evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+        if (conn) {
+            // No terminating chunk: freeing the connection frees the request with it
+            evhttp_connection_free(conn);
+        } else {
+            // The client is already gone, this only frees the request
+            evhttp_send_reply_end(req_copy);
         }
     });
     ev->trigger(nullptr);
-    replySent = true;
     req = 0; // transferred back to main thread
 }
 
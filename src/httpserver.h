@@ -6,6 +6,7 @@
 #ifndef BCZ_HTTPSERVER_H
 #define BCZ_HTTPSERVER_H
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <functional>
@@ -13,11 +14,14 @@
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+//! Bytes of a chunked reply waiting for the client before WriteReplyChunk blocks
+static const size_t MAX_HTTP_CHUNKED_BUFFERED = 1 << 20;
 
 struct evhttp_request;
 struct event_base;
 class CService;
 class HTTPRequest;
+struct HTTPChunkedReply;
 
 /** Initialize HTTP server.
  * Call this before RegisterHTTPHandler or EventBase().
@@ -60,6 +64,11 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    //! Output state of a chunked reply, shared with the events that send it
+    std::shared_ptr<HTTPChunkedReply> chunked;
+
+    /** Drop the connection of an unfinished chunked reply, so the client sees the body cut short */
+    void AbortReplyChunked();
 
 public:
     HTTPRequest(struct evhttp_request* req);
@@ -115,6 +124,27 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Start a chunked HTTP reply, for bodies produced incrementally.
+     * The body is sent with WriteReplyChunk and terminated with EndReplyChunked.
+     * A chunked reply not terminated (e.g. the handler threw) is aborted by
+     * closing the connection, it is never passed off as complete.
+     *
+     * @note Replaces WriteReply. Headers must be written before this.
+     */
+    void StartReplyChunked(int nStatus);
+    /**
+     * Queue a chunk of the body. Blocks while more than MAX_HTTP_CHUNKED_BUFFERED
+     * bytes wait to be sent, so a slow client makes the handler wait instead of
+     * the node buffering the whole reply. Chunks are dropped once the client is gone.
+     */
+    void WriteReplyChunk(std::string&& strChunk);
+    /**
+     * Terminate a chunked reply. As this will give the request back to the
+     * main thread, do not call any other HTTPRequest methods after calling this.
+     */
+    void EndReplyChunked();
 };
 
 /** Event handler closure.
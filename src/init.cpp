@@ -18,9 +18,12 @@
 #include "addrman.h"
 #include "amount.h"
 #include "bls/bls_wrapper.h"
+#include "chainstatesnapshot.h"
 #include "checkpoints.h"
+#include "coinstatsindex.h"
 #include "compat/sanity.h"
 #include "consensus/upgrades.h"
+#include "evo/specialtx_validation.h"
 #include "fs.h"
 #include "httpserver.h"
 #include "httprpc.h"
@@ -39,16 +42,19 @@
 #include "shutdown.h"
 #include "spork.h"
 #include "sporkdb.h"
+#include "startupstages.h"
 #include "tiertwo/init.h"
 #include "txdb.h"
 #include "torcontrol.h"
 #include "guiinterface.h"
 #include "guiinterfaceutil.h"
+#include "util/parallel.h"
 #include "util/system.h"
 #include "utilmoneystr.h"
 #include "util/threadnames.h"
 #include "validation.h"
 #include "validationinterface.h"
+#include "validationtrace.h"
 #include "warnings.h"
 
 #ifdef ENABLE_WALLET
@@ -213,6 +219,8 @@ void Shutdown()
     StopREST();
     StopRPC();
     StopHTTPServer();
+    // Startup stages still running read into the objects torn down below
+    g_startupStages.WaitAll();
     StopTierTwoThreads();
 #ifdef ENABLE_WALLET
     for (CWalletRef pwallet : vpwallets) {
@@ -234,6 +242,7 @@ void Shutdown()
     scheduler.stop();
     threadGroup.interrupt_all();
     threadGroup.join_all();
+    StopParallelWorkers();
 
     // After the threads that potentially access these pointers have been stopped,
     // destruct and reset all to nullptr.
@@ -278,6 +287,7 @@ void Shutdown()
             //record that client took the proper shutdown procedure
             pblocktree->WriteFlag("shutdown", true);
         }
+        g_coinStatsIndex.reset();
         pcoinsTip.reset();
         pcoinscatcher.reset();
         pcoinsdbview.reset();
@@ -286,6 +296,7 @@ void Shutdown()
         DeleteTierTwo();
     }
 #ifdef ENABLE_WALLET
+    UnloadPreloadedWallets();
     for (CWalletRef pwallet : vpwallets) {
         pwallet->Flush(true);
     }
@@ -406,11 +417,13 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-disablesystemnotifications", strprintf("Disable OS notifications for incoming transactions (default: %u)", 0));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf("Set database cache size in megabytes (%d to %d, default: %d)", nMinDbCache, nMaxDbCache, nDefaultDbCache));
     strUsage += HelpMessageOpt("-loadblock=<file>", "Imports blocks from external blk000??.dat file on startup");
+    strUsage += HelpMessageOpt("-loadchainstate=<file>", "Imports a chainstate snapshot written by dumpchainstate on startup, if the chainstate is empty. The snapshot block and its predecessors must already be in the blocks directory");
     strUsage += HelpMessageOpt("-maxreorg=<n>", strprintf("Set the Maximum reorg depth (default: %u)", DEFAULT_MAX_REORG_DEPTH));
+    strUsage += HelpMessageOpt("-blocktracesize=<n>", strprintf("Keep per-stage validation timings of the last <n> connected blocks for getblocktraces, 0 to disable (default: %u)", DEFAULT_BLOCK_TRACE_SIZE));
     strUsage += HelpMessageOpt("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS));
     strUsage += HelpMessageOpt("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE));
     strUsage += HelpMessageOpt("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY));
-    strUsage += HelpMessageOpt("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL));
+    strUsage += HelpMessageOpt("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart. Older versions cannot load the file written by this one and start with an empty mempool (default: %u)", DEFAULT_PERSIST_MEMPOOL));
     strUsage += HelpMessageOpt("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)", -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf("Specify pid file (default: %s)", BCZ_PID_FILENAME));
@@ -421,6 +434,7 @@ std::string HelpMessage(HelpMessageMode mode)
 #if !defined(WIN32)
     strUsage += HelpMessageOpt("-sysperms", "Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)");
 #endif
+    strUsage += HelpMessageOpt("-coinstatsindex", strprintf("Maintain the UTXO set statistics of every block, used by the gettxoutsetinfo rpc call (default: %u)", DEFAULT_COINSTATSINDEX));
     strUsage += HelpMessageOpt("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX));
     strUsage += HelpMessageOpt("-forcestart", "Attempt to force blockchain corruption recovery on startup");
 
@@ -474,6 +488,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-zmqpubhashtx=<address>", "Enable publish hash transaction in <address>");
     strUsage += HelpMessageOpt("-zmqpubrawblock=<address>", "Enable publish raw block in <address>");
     strUsage += HelpMessageOpt("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>");
+    strUsage += HelpMessageOpt("-zmqpubblocktrace=<address>", "Enable publish block validation timings (JSON, as returned by getblocktraces) in <address>");
 #endif
 
     strUsage += HelpMessageGroup("Debugging/Testing options:");
@@ -487,6 +502,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used");
         strUsage += HelpMessageOpt("-dropmessagestest=<n>", "Randomly drop 1 of every <n> network messages");
         strUsage += HelpMessageOpt("-fuzzmessagestest=<n>", "Randomly fuzz 1 of every <n> network messages");
+        strUsage += HelpMessageOpt("-lockholdwarnms=<n>", strprintf("Log (with -debug=lock) every hold of a profiled lock longer than <n> milliseconds, 0 to disable (default: %u)", DEFAULT_LOCK_HOLD_WARN_MS));
         strUsage += HelpMessageOpt("-stopafterblockimport", strprintf("Stop running after importing blocks from disk (default: %u)", DEFAULT_STOPAFTERBLOCKIMPORT));
         strUsage += HelpMessageOpt("-limitancestorcount=<n>", strprintf("Do not accept transactions if number of in-mempool ancestors is <n> or more (default: %u)", DEFAULT_ANCESTOR_LIMIT));
         strUsage += HelpMessageOpt("-limitancestorsize=<n>", strprintf("Do not accept transactions whose size with all in-mempool ancestors exceeds <n> kilobytes (default: %u)", DEFAULT_ANCESTOR_SIZE_LIMIT));
@@ -722,11 +738,13 @@ bool InitSanityCheck(void)
     return true;
 }
 
-static void LoadSaplingParams()
+static bool LoadSaplingParams()
 {
     struct timeval tv_start{}, tv_end{};
     float elapsed;
     gettimeofday(&tv_start, nullptr);
+    std::string strStatus;
+    if (!IsZKSNARKSReady(&strStatus)) uiInterface.InitMessage(strStatus);
     //fs::path ZC_GetBaseParamsDir();
     try {
         initZKSNARKS();
@@ -739,12 +757,13 @@ static void LoadSaplingParams()
                 GetDefaultDataDir()),
                                          "", CClientUIInterface::MSG_ERROR);
         StartShutdown();
-        return;
+        return false;
     }
 
     gettimeofday(&tv_end, nullptr);
     elapsed = float(tv_end.tv_sec-tv_start.tv_sec) + (tv_end.tv_usec-tv_start.tv_usec)/float(1000000);
     LogPrintf("Loaded Sapling parameters in %fs seconds.\n", elapsed);
+    return true;
 }
 
 bool AppInitServers()
@@ -1038,6 +1057,8 @@ bool AppInitParameterInteraction()
         mempool.setSanityCheck(1.0 / ratio);
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", Params().DefaultConsistencyChecks());
+    SetLockHoldWarnThreshold(std::max<int64_t>(gArgs.GetArg("-lockholdwarnms", DEFAULT_LOCK_HOLD_WARN_MS), 0));
+    g_blockTraces.Resize(std::max<int64_t>(gArgs.GetArg("-blocktracesize", DEFAULT_BLOCK_TRACE_SIZE), 0));
     Checkpoints::fEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
 
     // -mempoollimit limits
@@ -1198,9 +1219,13 @@ bool AppInitMain()
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
-        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+        for (int i = 0; i < nScriptCheckThreads - 1; i++) {
             threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(&ThreadSpecialTxCheck);
+        }
     }
+    // Data-parallel helpers (Sapling tree levels, wallet load) get as many threads
+    StartParallelWorkers(nScriptCheckThreads - 1);
 
     if (gArgs.IsArgSet("-sporkkey")) // spork priv key
     {
@@ -1219,9 +1244,6 @@ bool AppInitMain()
 
     GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
 
-    // Initialize Sapling circuit parameters
-    LoadSaplingParams();
-
     /* Register RPC commands regardless of -server setting so they will be
      * available in the GUI RPC console even if external calls are disabled.
      */
@@ -1241,6 +1263,12 @@ bool AppInitMain()
             return UIError(_("Unable to start HTTP server. See debug log for details."));
     }
 
+    // Initialize Sapling circuit parameters. Reading and hashing them takes a few
+    // seconds, so it is done in the background: only Sapling proof verification
+    // and creation wait for it (see WaitForZKSNARKS). Started after the RPC server,
+    // so the warm-up status reports the loading.
+    g_startupStages.Launch("sapling_params", &LoadSaplingParams);
+
     if (gArgs.GetBoolArg("-resync", false)) {
         uiInterface.InitMessage(_("Preparing for resync..."));
         // Delete the local blockchain folders to force a resync from scratch to get a consitent blockchain-state
@@ -1416,6 +1444,13 @@ bool AppInitMain()
     fReindex = gArgs.GetBoolArg("-reindex", false);
     bool fReindexChainState = gArgs.GetBoolArg("-reindex-chainstate", false);
 
+    // The wallet databases and the tier-two flat-file caches do not depend on
+    // the chain: read them while the block index loads (see Step 8 and Step 10)
+#ifdef ENABLE_WALLET
+    g_startupStages.Launch("wallet_db", &PreloadWallets);
+#endif
+    g_startupStages.Launch("tiertwo_caches", std::bind(&LoadTierTwoCaches, !(fReindex || fReindexChainState)));
+
     // cache size calculations
     int64_t nTotalCache = (gArgs.GetArg("-dbcache", nDefaultDbCache) << 20);
     nTotalCache = std::max(nTotalCache, nMinDbCache << 20); // total cache cannot be less than nMinDbCache
@@ -1435,6 +1470,7 @@ bool AppInitMain()
     const CChainParams& chainparams = Params();
     const Consensus::Params& consensus = chainparams.GetConsensus();
 
+    const size_t nBlockIndexStage = g_startupStages.Begin("block_index");
     bool fLoaded = false;
     while (!fLoaded && !ShutdownRequested()) {
         bool fReset = fReindex;
@@ -1515,6 +1551,16 @@ bool AppInitMain()
                     break;
                 }
 
+                // Provision an empty chainstate from a snapshot instead of connecting all the history
+                if (gArgs.IsArgSet("-loadchainstate") && !fReset && !fReindexChainState && pcoinsdbview->GetBestBlock().IsNull()) {
+                    uiInterface.InitMessage(_("Loading chainstate snapshot..."));
+                    ChainstateSnapshotMetadata snapshot;
+                    std::string strSnapshotError;
+                    if (!LoadChainstateSnapshot(AbsPathForConfigVal(gArgs.GetArg("-loadchainstate", "")), *pcoinsdbview, snapshot, strSnapshotError)) {
+                        return UIError(strprintf(_("Unable to load chainstate snapshot: %s"), strSnapshotError));
+                    }
+                }
+
                 // ReplayBlocks is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
                 if (!ReplayBlocks(chainparams, pcoinsdbview.get())) {
                     strLoadError = strprintf(_("Unable to replay blocks. You will need to rebuild the database using %s."), "-reindex");
@@ -1581,6 +1627,8 @@ bool AppInitMain()
         }
     }
 
+    g_startupStages.End(nBlockIndexStage, fLoaded);
+
     // As LoadBlockIndex can take several minutes, it's possible the user
     // requested to kill the GUI during the last operation. If so, exit.
     // As the program has not fully started yet, Shutdown() is possibly overkill.
@@ -1589,6 +1637,23 @@ bool AppInitMain()
         return false;
     }
 
+    if (gArgs.GetBoolArg("-coinstatsindex", DEFAULT_COINSTATSINDEX)) {
+        uiInterface.InitMessage(_("Loading coin statistics index..."));
+        LOCK(cs_main);
+        const size_t nCoinStatsStage = g_startupStages.Begin("coinstats_index");
+        g_coinStatsIndex.reset(new CCoinStatsIndex(nCoinStatsIndexCache << 20, false, fReindex));
+        const bool fCoinStatsLoaded = g_coinStatsIndex->Init(pcoinsdbview.get());
+        g_startupStages.End(nCoinStatsStage, fCoinStatsLoaded);
+        if (!fCoinStatsLoaded) {
+            g_coinStatsIndex.reset();
+            if (ShutdownRequested()) {
+                LogPrintf("Shutdown requested. Exiting.\n");
+                return false;
+            }
+            return UIError(_("Error initializing the coin statistics index"));
+        }
+    }
+
     fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
     CAutoFile est_filein(fsbridge::fopen(est_path, "rb"), SER_DISK, CLIENT_VERSION);
     // Allowed to fail as this file IS missing on first startup.
@@ -1598,8 +1663,12 @@ bool AppInitMain()
 
 // ********************************************************* Step 8: Backup and Load wallet
 #ifdef ENABLE_WALLET
+    if (!g_startupStages.Wait("wallet_db"))
+        return false;
+    const size_t nWalletStage = g_startupStages.Begin("wallet");
     if (!InitLoadWallet())
         return false;
+    g_startupStages.End(nWalletStage);
 #else
     LogPrintf("No wallet compiled in!\n");
 #endif
@@ -1672,7 +1741,7 @@ bool AppInitMain()
     // Update money supply
     if (!fReindex && !fReindexChainState) {
         uiInterface.InitMessage(_("Calculating money supply..."));
-        MoneySupply.Update(pcoinsTip->GetTotalAmount(), chain_active_height);
+        MoneySupply.Update(g_coinStatsIndex ? g_coinStatsIndex->GetTotalAmount() : pcoinsTip->GetTotalAmount(), chain_active_height);
     }
 
 
@@ -1687,8 +1756,12 @@ bool AppInitMain()
         }
     }
 
+    if (!g_startupStages.Wait("tiertwo_caches"))
+        return false;
+    const size_t nTierTwoStage = g_startupStages.Begin("tiertwo");
     LoadTierTwo(chain_active_height, load_cache_files);
     RegisterTierTwoValidationInterface();
+    g_startupStages.End(nTierTwoStage);
 
 
     // Start tier two threads and jobs
@@ -1805,6 +1878,7 @@ bool AppInitMain()
 
     // ********************************************************* Step 12: finished
 
+    g_startupStages.Finish();
     SetRPCWarmupFinished();
     uiInterface.InitMessage(_("Done loading"));
 
@@ -65,7 +65,7 @@ static bool errorFinalCommitment(const char* fmt, const Args&... args)
     return false;
 }
 
-bool CFinalCommitment::Verify(const std::vector<CBLSPublicKey>& allkeys, const Consensus::LLMQParams& params) const
+bool CFinalCommitment::Verify(const std::vector<CBLSPublicKey>& allkeys, const Consensus::LLMQParams& params, bool fCheckQuorumSig) const
 {
     int count_validmembers = CountValidMembers();
     if (count_validmembers < params.minSize) {
@@ -110,7 +110,7 @@ bool CFinalCommitment::Verify(const std::vector<CBLSPublicKey>& allkeys, const C
     if (!membersSig.VerifySecureAggregated(memberPubKeys, commitmentHash)) {
         return errorFinalCommitment("aggregated members signature");
     }
-    if (!quorumSig.VerifyInsecure(quorumPublicKey, commitmentHash)) {
+    if (fCheckQuorumSig && !quorumSig.VerifyInsecure(quorumPublicKey, commitmentHash)) {
         return errorFinalCommitment("invalid quorum signature");
     }
 
@@ -48,7 +48,8 @@ public:
     bool IsNull() const;
     void ToJson(UniValue& obj) const;
 
-    bool Verify(const std::vector<CBLSPublicKey>& allkeys, const Consensus::LLMQParams& params) const;
+    // fCheckQuorumSig=false leaves the quorum signature to the caller, to verify it in a batch
+    bool Verify(const std::vector<CBLSPublicKey>& allkeys, const Consensus::LLMQParams& params, bool fCheckQuorumSig = true) const;
     bool VerifySizes(const Consensus::LLMQParams& params) const;
 
     SERIALIZE_METHODS(CFinalCommitment, obj)
@@ -338,70 +338,106 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 
     logger.Batch("decrypted our contribution share. time=%d", t2.count());
 
-    bool verifyPending = false;
     receivedSkContributions[member->idx] = skContribution;
     pendingContributionVerifications.emplace_back(member->idx);
-    if (pendingContributionVerifications.size() >= 32) {
-        verifyPending = true;
+    // Batches are verified on the BLS worker while the next contributions come in,
+    // so keep them small enough to start before the phase is over
+    if (pendingContributionVerifications.size() >= 8) {
+        VerifyPendingContributions();
     }
+}
 
-    if (verifyPending) {
-        VerifyPendingContributions();
+CDKGSession::~CDKGSession()
+{
+    // The worker references the inputs of the batches still running. When it is stopped,
+    // queued jobs are dropped and never touch them.
+    if (blsWorker.IsRunning()) {
+        for (auto& batch : contributionVerificationBatches) {
+            batch.result.wait();
+        }
     }
 }
 
-// Verifies all pending secret key contributions in one batch
+// Starts the verification of all pending secret key contributions in one batch on the BLS worker
 // This is done by aggregating the verification vectors belonging to the secret key contributions
 // The resulting aggregated vvec is then used to recover a public key share
 // The public key share must match the public key belonging to the aggregated secret key contributions
-// See CBLSWorker::VerifyContributionShares for more details.
+// See CBLSWorker::VerifyContributionShares for more details. The results are taken by
+// ProcessContributionVerifications.
 void CDKGSession::VerifyPendingContributions()
 {
-    CDKGLogger logger(*this, __func__);
-
-    cxxtimer::Timer t1(true);
-
     std::vector<size_t> pend = std::move(pendingContributionVerifications);
     if (pend.empty()) {
         return;
     }
 
-    std::vector<size_t> memberIndexes;
-    std::vector<BLSVerificationVectorPtr> vvecs;
-    BLSSecretKeyVector skContributions;
-
+    contributionVerificationBatches.emplace_back();
+    auto& batch = contributionVerificationBatches.back();
     for (const auto& idx : pend) {
         auto& m = members[idx];
         if (m->bad || m->weComplain) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
-        vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        batch.memberIndexes.emplace_back(idx);
+        batch.vvecs.emplace_back(receivedVvecs[idx]);
+        batch.skContributions.emplace_back(receivedSkContributions[idx]);
     }
-
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    if (batch.memberIndexes.empty()) {
+        contributionVerificationBatches.pop_back();
         return;
     }
+    batch.result = blsWorker.AsyncVerifyContributionShares(myId, batch.vvecs, batch.skContributions, true, true);
+}
 
-    for (size_t i = 0; i < memberIndexes.size(); i++) {
-        if (!result[i]) {
-            auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.weComplain = true;
-                return true;
-            });
-        } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+// Applies the results of the finished contribution verification batches, or of all of them if fWait is set.
+// Returns true if any batch was processed.
+bool CDKGSession::ProcessContributionVerifications(bool fWait)
+{
+    if (contributionVerificationBatches.empty()) {
+        return false;
+    }
+
+    CDKGLogger logger(*this, __func__);
+
+    cxxtimer::Timer t1(true);
+
+    size_t nVerified = 0;
+    for (auto it = contributionVerificationBatches.begin(); it != contributionVerificationBatches.end(); ) {
+        if (!fWait && it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
         }
+        const auto& memberIndexes = it->memberIndexes;
+        auto result = it->result.get();
+        if (result.size() != memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+            it = contributionVerificationBatches.erase(it);
+            continue;
+        }
+
+        for (size_t i = 0; i < memberIndexes.size(); i++) {
+            if (!result[i]) {
+                auto& m = members[memberIndexes[i]];
+                logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                m->weComplain = true;
+                quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
+                    status.weComplain = true;
+                    return true;
+                });
+            } else {
+                size_t memberIdx = memberIndexes[i];
+                dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, it->skContributions[i]);
+            }
+        }
+        nVerified += memberIndexes.size();
+        it = contributionVerificationBatches.erase(it);
     }
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+    if (nVerified == 0) {
+        return false;
+    }
+    logger.Batch("verified %d pending contributions. time=%d", nVerified, t1.count());
+    return true;
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -411,6 +447,7 @@ void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
     }
 
     VerifyPendingContributions();
+    ProcessContributionVerifications(true);
 
     CDKGLogger logger(*this, __func__);
 
@@ -1215,7 +1252,9 @@ std::vector<CFinalCommitment> CDKGSession::FinalizeCommitments()
 
     const CChainParams& chainparams = Params();
 
-    std::vector<CFinalCommitment> finalCommitments;
+    // Candidates are built first, and their quorum signatures verified below in one batch
+    std::vector<CFinalCommitment> candidates;
+    std::vector<uint256> candidateHashes;
     for (const auto& p : commitmentsMap) {
         auto& cvec = p.second;
         if (cvec.size() < (size_t)params.minSize) {
@@ -1271,18 +1310,51 @@ std::vector<CFinalCommitment> CDKGSession::FinalizeCommitments()
         t2.stop();
 
         cxxtimer::Timer t3(true);
-        if (!fqc.Verify(allkeys, params)) {
+        if (!fqc.Verify(allkeys, params, false)) {
             logger.Batch("failed to verify final commitment");
             continue;
         }
         t3.stop();
 
-        finalCommitments.emplace_back(fqc);
-
-        logger.Batch("final commitment: validMembers=%d, signers=%d, quorumPublicKey=%s, time1=%d, time2=%d, time3=%d, total=%d",
+        logger.Batch("candidate commitment: validMembers=%d, signers=%d, quorumPublicKey=%s, time1=%d, time2=%d, time3=%d",
                         fqc.CountValidMembers(), fqc.CountSigners(), bls::EncodePublic(chainparams, fqc.quorumPublicKey),
-                        t1.count(), t2.count(), t3.count(), totalTimer.count());
+                        t1.count(), t2.count(), t3.count());
+
+        candidates.emplace_back(std::move(fqc));
+        candidateHashes.emplace_back(commitmentHash);
+    }
+
+    // Each candidate has its own validMembers, hence its own commitment hash, so the
+    // quorum signatures can be checked with a single aggregated verification
+    cxxtimer::Timer t4(true);
+    std::vector<bool> validQuorumSigs(candidates.size(), true);
+    if (!candidates.empty()) {
+        std::vector<CBLSSignature> quorumSigs;
+        std::vector<CBLSPublicKey> quorumPublicKeys;
+        for (const auto& fqc : candidates) {
+            quorumSigs.emplace_back(fqc.quorumSig);
+            quorumPublicKeys.emplace_back(fqc.quorumPublicKey);
+        }
+        if (!CBLSSignature::AggregateInsecure(quorumSigs).VerifyInsecureAggregated(quorumPublicKeys, candidateHashes)) {
+            // find the bad ones
+            for (size_t i = 0; i < candidates.size(); i++) {
+                validQuorumSigs[i] = candidates[i].quorumSig.VerifyInsecure(candidates[i].quorumPublicKey, candidateHashes[i]);
+            }
+        }
     }
+    t4.stop();
+
+    std::vector<CFinalCommitment> finalCommitments;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (!validQuorumSigs[i]) {
+            logger.Batch("failed to verify quorum signature of final commitment, quorumPublicKey=%s", bls::EncodePublic(chainparams, candidates[i].quorumPublicKey));
+            continue;
+        }
+        finalCommitments.emplace_back(std::move(candidates[i]));
+    }
+
+    logger.Batch("final commitments: candidates=%d, valid=%d, time4=%d, total=%d",
+                    candidates.size(), finalCommitments.size(), t4.count(), totalTimer.count());
 
     totalTimer.stop();
     logger.Flush();
@@ -18,6 +18,9 @@
 namespace llmq
 {
 
+// Upper bound of a phase handler wait when nothing wakes it up
+static const int64_t PHASE_WAKEUP_TIMEOUT = 1000;
+
 CDKGPendingMessages::CDKGPendingMessages(size_t _maxMessagesPerNode) :
     maxMessagesPerNode(_maxMessagesPerNode)
 {
@@ -126,6 +129,8 @@ void CDKGSessionHandler::UpdatedBlockTip(const CBlockIndex* pindexNew)
 
     LogPrint(BCLog::DKG, "CDKGSessionHandler::%s -- %s - currentHeight=%d, quorumHeight=%d, oldPhase=%d, newPhase=%d\n", __func__,
             params.name, currentHeight, quorumHeight, oldPhase, phase);
+
+    WakeupPhaseHandler();
 }
 
 void CDKGSessionHandler::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv)
@@ -139,7 +144,10 @@ void CDKGSessionHandler::ProcessMessage(CNode* pfrom, const std::string& strComm
         pendingJustifications.PushPendingMessage(pfrom->GetId(), vRecv, MSG_QUORUM_JUSTIFICATION);
     } else if (strCommand == NetMsgType::QPCOMMITMENT) {
         pendingPrematureCommitments.PushPendingMessage(pfrom->GetId(), vRecv, MSG_QUORUM_PREMATURE_COMMITMENT);
+    } else {
+        return;
     }
+    WakeupPhaseHandler();
 }
 
 void CDKGSessionHandler::StartThread()
@@ -155,6 +163,7 @@ void CDKGSessionHandler::StartThread()
 void CDKGSessionHandler::StopThread()
 {
     stopRequested = true;
+    WakeupPhaseHandler();
     if (phaseHandlerThread.joinable()) {
         phaseHandlerThread.join();
     }
@@ -184,6 +193,24 @@ CDKGSessionHandler::QuorumPhaseAndHash CDKGSessionHandler::GetPhaseAndQuorumHash
     return {phase, quorumHash};
 }
 
+void CDKGSessionHandler::WakeupPhaseHandler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexPhaseWake);
+        fPhaseWake = true;
+    }
+    condPhaseWake.notify_one();
+}
+
+// A wakeup that came in while the caller was busy returns immediately. The timeout
+// bounds the wait for what does not notify (ShutdownRequested, sleep deadlines).
+void CDKGSessionHandler::WaitForPhaseWakeup(int64_t nMaxWaitMillis)
+{
+    std::unique_lock<std::mutex> lock(mutexPhaseWake);
+    condPhaseWake.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max<int64_t>(nMaxWaitMillis, 0)), [this] { return fPhaseWake; });
+    fPhaseWake = false;
+}
+
 class AbortPhaseException : public std::exception {
 };
 
@@ -210,7 +237,7 @@ void CDKGSessionHandler::WaitForNextPhase(QuorumPhase curPhase,
             throw AbortPhaseException();
         }
         if (!runWhileWaiting()) {
-            MilliSleep(100);
+            WaitForPhaseWakeup(PHASE_WAKEUP_TIMEOUT);
         }
     }
 
@@ -240,7 +267,7 @@ void CDKGSessionHandler::WaitForNewQuorum(const uint256& oldQuorumHash)
         if (currState.quorumHash != oldQuorumHash) {
             break;
         }
-        MilliSleep(100);
+        WaitForPhaseWakeup(PHASE_WAKEUP_TIMEOUT);
     }
 
     LogPrint(BCLog::DKG, "CDKGSessionHandler::%s -- %s - done\n", __func__, params.name);
@@ -285,7 +312,8 @@ void CDKGSessionHandler::SleepBeforePhase(QuorumPhase curPhase,
 
     LogPrint(BCLog::DKG, "CDKGSessionHandler::%s -- %s - starting sleep for %d ms, curPhase=%d\n", __func__, params.name, sleepTime, curPhase);
 
-    while (GetTimeMillis() < endTime) {
+    int64_t nNow;
+    while ((nNow = GetTimeMillis()) < endTime) {
         if (stopRequested) {
             LogPrint(BCLog::DKG, "CDKGSessionHandler::%s -- %s - aborting due to stop/shutdown requested\n", __func__, params.name);
             throw AbortPhaseException();
@@ -308,7 +336,7 @@ void CDKGSessionHandler::SleepBeforePhase(QuorumPhase curPhase,
             }
         }
         if (!runWhileWaiting()) {
-            MilliSleep(100);
+            WaitForPhaseWakeup(std::min(endTime - nNow, PHASE_WAKEUP_TIMEOUT));
         }
     }
 
@@ -543,7 +571,8 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->Contribute(pendingContributions);
     };
     auto fContributeWait = [this] {
-        return ProcessPendingMessageBatch<CDKGContribution>(*curSession, pendingContributions, 8);
+        bool fProcessed = ProcessPendingMessageBatch<CDKGContribution>(*curSession, pendingContributions, 8);
+        return curSession->ProcessContributionVerifications(false) || fProcessed;
     };
     HandlePhase(QuorumPhase_Contribute, QuorumPhase_Complain, curQuorumHash, 0.05, fContributeStart, fContributeWait);
 
@@ -10,6 +10,8 @@
 #include "llmq/quorums_dkgsession.h"
 #include "validation.h"
 
+#include <condition_variable>
+
 namespace llmq
 {
 
@@ -111,6 +113,11 @@ private:
     std::shared_ptr<CDKGSession> curSession;
     std::thread phaseHandlerThread;
 
+    // Wakes up the phase handler thread on new blocks, new messages and stop requests
+    bool fPhaseWake{false};
+    std::condition_variable condPhaseWake;
+    std::mutex mutexPhaseWake;
+
     CDKGPendingMessages pendingContributions;
     CDKGPendingMessages pendingComplaints;
     CDKGPendingMessages pendingJustifications;
@@ -135,6 +142,9 @@ private:
     };
     QuorumPhaseAndHash GetPhaseAndQuorumHash() const;
 
+    void WakeupPhaseHandler();
+    void WaitForPhaseWakeup(int64_t nMaxWaitMillis);
+
     typedef std::function<void()> StartPhaseFunc;
     typedef std::function<bool()> WhileWaitFunc;
     void WaitForNextPhase(QuorumPhase curPhase, QuorumPhase nextPhase, const uint256& expectedQuorumHash, const WhileWaitFunc& runWhileWaiting);
@@ -6,12 +6,16 @@
 #ifndef BCZ_LLMQ_INIT_H
 #define BCZ_LLMQ_INIT_H
 
+class CBLSWorker;
 class CDBWrapper;
 class CEvoDB;
 
 namespace llmq
 {
 
+// Shared BLS worker (DKG, batched signature verification of tier two messages)
+extern CBLSWorker* blsWorker;
+
 // Init/destroy LLMQ globals
 void InitLLMQSystem(CEvoDB& evoDb);
 void DestroyLLMQSystem();
@@ -391,7 +391,9 @@ bool CMasternodePayments::ProcessMNWinner(CMasternodePaymentWinner& winner, CNod
         return state.Error("MN already voted");
     }
 
-    // Check signature
+    // Check signature. Unlike MNAUTH, this is not handed to the BLS worker: mnw messages
+    // are dropped unparsed by ProcessMessageMasternodePayments, so nothing reaches here
+    // from the network handler.
     bool is_valid_sig = dmn ? winner.CheckSignature(dmn->pdmnState->pubKeyOperator.Get())
                             : winner.CheckSignature(pmn->pubKeyMasternode.GetID());
 
@@ -692,6 +692,9 @@ bool CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 
 int CMasternodeMan::ProcessMessageInner(CNode* pfrom, std::string& strCommand, CDataStream& vRecv)
 {
+    // Legacy masternode broadcasts and pings are not processed anymore: masternodes are
+    // tracked by the deterministic list, and mnb/mnp messages are dropped here unparsed.
+    // ProcessMNBroadcast/ProcessMNPing are not called from anywhere.
     return 0;
 }
 
@@ -205,6 +205,9 @@ public:
 
     void PushMessage(CNode* pnode, CSerializedNetMsg&& msg);
 
+    // Wake the message handler, e.g. when held back messages of a peer can be processed again
+    void WakeMessageHandler();
+
     template<typename Callable>
     bool ForEachNodeContinueIf(Callable&& func)
     {
@@ -376,8 +379,6 @@ private:
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
 
-    void WakeMessageHandler();
-
     uint64_t CalculateKeyedNetGroup(const CAddress& ad);
 
     CNode* FindNode(const CNetAddr& ip);
@@ -434,10 +435,10 @@ private:
     std::deque<std::string> vOneShots;
     RecursiveMutex cs_vOneShots;
     std::vector<std::string> vAddedNodes GUARDED_BY(cs_vAddedNodes);
-    RecursiveMutex cs_vAddedNodes;
+    RecursiveMutex cs_vAddedNodes{"connman.cs_vAddedNodes"};
     std::vector<CNode*> vNodes;
     std::list<CNode*> vNodesDisconnected;
-    mutable RecursiveMutex cs_vNodes;
+    mutable RecursiveMutex cs_vNodes{"connman.cs_vNodes"};
     std::atomic<NodeId> nLastNodeId;
     unsigned int nPrevNodeCount;
 
@@ -643,11 +644,11 @@ public:
     size_t nSendOffset; // offset inside the first vSendMsg already sent
     uint64_t nSendBytes;
     std::deque<std::vector<unsigned char>> vSendMsg;
-    RecursiveMutex cs_vSend;
+    RecursiveMutex cs_vSend{"node.cs_vSend"};
     RecursiveMutex cs_hSocket;
-    RecursiveMutex cs_vRecv;
+    RecursiveMutex cs_vRecv{"node.cs_vRecv"};
 
-    RecursiveMutex cs_vProcessMsg;
+    RecursiveMutex cs_vProcessMsg{"node.cs_vProcessMsg"};
     std::list<CNetMessage> vProcessMsg;
     size_t nProcessQueueSize;
 
@@ -762,6 +763,8 @@ public:
     uint256 receivedMNAuthChallenge;
     uint256 verifiedProRegTxHash; // MN provider register tx hash
     uint256 verifiedPubKeyHash; // MN operator pubkey hash
+    // Set while the signature of the received MNAUTH is verified; the peer's next messages wait for it
+    std::atomic<bool> fMNAuthPending{false};
 
     CNode(NodeId id, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn, SOCKET hSocketIn, const CAddress& addrIn, uint64_t nKeyedNetGroupIn, uint64_t nLocalHostNonceIn, const std::string& addrNameIn = "", bool fInboundIn = false);
     ~CNode();
@@ -9,6 +9,7 @@
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "httpserver.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "streams.h"
 #include "sync.h"
@@ -60,6 +61,8 @@ extern void TxToJSON(CWallet* const pwallet, const CTransaction& tx, const CBloc
 extern UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails = false);
 extern UniValue mempoolInfoToJSON();
 extern UniValue mempoolToJSON(bool fVerbose = false);
+extern void blockToJSONStream(CJSONStreamWriter& writer, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails);
+extern void mempoolToJSONStream(CJSONStreamWriter& writer);
 extern UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex);
 
 static bool RESTERR(HTTPRequest* req, enum HTTPStatusCode status, std::string message)
@@ -69,6 +72,34 @@ static bool RESTERR(HTTPRequest* req, enum HTTPStatusCode status, std::string me
     return false;
 }
 
+/**
+ * Reply with the JSON document written by fn. The reply switches to chunked
+ * transfer once the document outgrows the writer's buffer; until then nothing
+ * has been sent, so fn may still fail the request.
+ */
+static void WriteJSONReplyStream(HTTPRequest* req, const std::function<void(CJSONStreamWriter&)>& fn)
+{
+    bool fStarted = false;
+    bool fFinishing = false;
+    CJSONStreamWriter writer([&](std::string&& chunk) {
+        if (!fStarted && fFinishing) {
+            req->WriteReply(HTTP_OK, chunk);
+            return;
+        }
+        if (!fStarted) {
+            req->StartReplyChunked(HTTP_OK);
+            fStarted = true;
+        }
+        req->WriteReplyChunk(std::move(chunk));
+    });
+    fn(writer);
+    fFinishing = true;
+    writer.Finish();
+    if (fStarted) {
+        req->EndReplyChunked();
+    }
+}
+
 static enum RetFormat ParseDataFormat(std::vector<std::string>& params, const std::string& strReq)
 {
     boost::split(params, strReq, boost::is_any_of("."));
@@ -228,10 +259,10 @@ static bool rest_block(HTTPRequest* req,
     }
 
     case RF_JSON: {
-        UniValue objBlock = blockToJSON(block, tip, pblockindex, showTxDetails);
-        std::string strJSON = objBlock.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        WriteJSONReplyStream(req, [&](CJSONStreamWriter& writer) {
+            blockToJSONStream(writer, block, tip, pblockindex, showTxDetails);
+        });
         return true;
     }
 
@@ -308,11 +339,8 @@ static bool rest_mempool_contents(HTTPRequest* req, const std::string& strURIPar
 
     switch (rf) {
     case RF_JSON: {
-        UniValue mempoolObject = mempoolToJSON(true);
-
-        std::string strJSON = mempoolObject.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        WriteJSONReplyStream(req, mempoolToJSONStream);
         return true;
     }
     default: {
@@ -5,8 +5,10 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or https://www.opensource.org/licenses/mit-license.php.
 
+#include "chainstatesnapshot.h"
 #include "checkpoints.h"
 #include "clientversion.h"
+#include "coinstatsindex.h"
 #include "core_io.h"
 #include "consensus/upgrades.h"
 #include "kernel.h"
@@ -14,6 +16,7 @@
 #include "masternodeman.h"
 #include "policy/feerate.h"
 #include "policy/policy.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "sync.h"
 #include "txdb.h"
@@ -22,6 +25,7 @@
 #include "utilstrencodings.h"
 #include "hash.h"
 #include "validationinterface.h"
+#include "validationtrace.h"
 #include "wallet/wallet.h"
 #include "warnings.h"
 
@@ -133,28 +137,20 @@ UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex
     return result;
 }
 
-UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails = false)
+/** The fields of blockToJSON before ("hash" to "merkleroot") and after ("time" onwards) the "tx" array */
+static void blockFieldsToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, UniValue& head, UniValue& result)
 {
-    UniValue result(UniValue::VOBJ);
-    result.pushKV("hash", block.GetHash().GetHex());
+    head.setObject();
+    head.pushKV("hash", block.GetHash().GetHex());
     const CBlockIndex* pnext;
     int confirmations = ComputeNextBlockAndDepth(tip, blockindex, pnext);
-    result.pushKV("confirmations", confirmations);
-    result.pushKV("size", (int)::GetSerializeSize(block, PROTOCOL_VERSION));
-    result.pushKV("height", blockindex->nHeight);
-    result.pushKV("version", block.nVersion);
-    result.pushKV("merkleroot", block.hashMerkleRoot.GetHex());
-    UniValue txs(UniValue::VARR);
-    for (const auto& txIn : block.vtx) {
-        const CTransaction& tx = *txIn;
-        if (txDetails) {
-            UniValue objTx(UniValue::VOBJ);
-            TxToJSON(nullptr, tx, nullptr, nullptr, objTx);
-            txs.push_back(objTx);
-        } else
-            txs.push_back(tx.GetHash().GetHex());
-    }
-    result.pushKV("tx", txs);
+    head.pushKV("confirmations", confirmations);
+    head.pushKV("size", (int)::GetSerializeSize(block, PROTOCOL_VERSION));
+    head.pushKV("height", blockindex->nHeight);
+    head.pushKV("version", block.nVersion);
+    head.pushKV("merkleroot", block.hashMerkleRoot.GetHex());
+
+    result.setObject();
     result.pushKV("time", block.GetBlockTime());
     result.pushKV("mediantime", (int64_t)blockindex->GetMedianTimePast());
     result.pushKV("nonce", (uint64_t)block.nNonce);
@@ -178,10 +174,48 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIn
         result.pushKV("stakeModifier", blockindex->GetStakeModifierV2().GetHex());
         result.pushKV("hashProofOfStake", hashProofOfStakeRet.GetHex());
     }
+}
+
+static UniValue blockTxToJSON(const CTransaction& tx, bool txDetails)
+{
+    if (!txDetails) {
+        return tx.GetHash().GetHex();
+    }
+    UniValue objTx(UniValue::VOBJ);
+    TxToJSON(nullptr, tx, nullptr, nullptr, objTx);
+    return objTx;
+}
 
+UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails = false)
+{
+    UniValue result, tail;
+    blockFieldsToJSON(block, tip, blockindex, result, tail);
+    UniValue txs(UniValue::VARR);
+    for (const auto& txIn : block.vtx) {
+        txs.push_back(blockTxToJSON(*txIn, txDetails));
+    }
+    result.pushKV("tx", txs);
+    result.pushKVs(tail);
     return result;
 }
 
+void blockToJSONStream(CJSONStreamWriter& writer, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails)
+{
+    // Everything that may fail is computed before the first byte is written
+    UniValue head, tail;
+    blockFieldsToJSON(block, tip, blockindex, head, tail);
+    writer.BeginObject();
+    writer.ObjectEntries(head);
+    writer.Key("tx");
+    writer.BeginArray();
+    for (const auto& txIn : block.vtx) {
+        writer.Value(blockTxToJSON(*txIn, txDetails));
+    }
+    writer.EndArray();
+    writer.ObjectEntries(tail);
+    writer.EndObject();
+}
+
 UniValue getblockcount(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -456,6 +490,26 @@ UniValue mempoolToJSON(bool fVerbose = false)
     }
 }
 
+void mempoolToJSONStream(CJSONStreamWriter& writer)
+{
+    // The writer may block on a slow client, so mempool.cs is only taken per
+    // entry; transactions removed in the meantime are skipped.
+    std::vector<uint256> vtxid;
+    mempool.queryHashes(vtxid);
+    writer.BeginObject();
+    for (const uint256& hash : vtxid) {
+        UniValue info(UniValue::VOBJ);
+        {
+            LOCK(mempool.cs);
+            auto it = mempool.mapTx.find(hash);
+            if (it == mempool.mapTx.end()) continue;
+            entryToJSON(info, *it);
+        }
+        writer.KeyValue(hash.ToString(), info);
+    }
+    writer.EndObject();
+}
+
 UniValue getrawmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 1)
@@ -702,30 +756,45 @@ struct CCoinsStats
     CAmount nTotalAmount{0};
 };
 
-static void ApplyStats(CCoinsStats &stats, CHashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
+enum class CoinStatsHashType {
+    HASH_SERIALIZED,
+    MUHASH,
+    NONE,
+};
+
+static void ApplyStats(CCoinsStats &stats, CHashWriter& ss, CCoinStatsDelta& muhash, CoinStatsHashType hash_type, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
 {
     assert(!outputs.empty());
-    ss << hash;
     const Coin& coin = outputs.begin()->second;
-    ss << VARINT(coin.nHeight * 4 + (coin.fCoinBase ? 2u : 0u) + (coin.fCoinStake ? 1u : 0u));
+    if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+        ss << hash;
+        ss << VARINT(coin.nHeight * 4 + (coin.fCoinBase ? 2u : 0u) + (coin.fCoinStake ? 1u : 0u));
+    }
     stats.nTransactions++;
     for (const auto& output : outputs) {
-        ss << VARINT(output.first + 1);
-        ss << output.second.out.scriptPubKey;
-        ss << VARINT_MODE(output.second.out.nValue, VarIntMode::NONNEGATIVE_SIGNED);
+        if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+            ss << VARINT(output.first + 1);
+            ss << output.second.out.scriptPubKey;
+            ss << VARINT_MODE(output.second.out.nValue, VarIntMode::NONNEGATIVE_SIGNED);
+        } else if (hash_type == CoinStatsHashType::MUHASH) {
+            muhash.AddCoin(COutPoint(hash, output.first), output.second);
+        }
         stats.nTransactionOutputs++;
         stats.nTotalAmount += output.second.out.nValue;
     }
-    ss << VARINT(0u);
+    if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+        ss << VARINT(0u);
+    }
 }
 
 //! Calculate statistics about the unspent transaction output set
-static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats)
+static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats, CoinStatsHashType hash_type)
 {
     std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
     assert(pcursor);
 
     CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    CCoinStatsDelta muhash;
     stats.hashBlock = pcursor->GetBestBlock();
     {
         LOCK(cs_main);
@@ -740,7 +809,7 @@ static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats)
         Coin coin;
         if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
             if (!outputs.empty() && key.hash != prevkey) {
-                ApplyStats(stats, ss, prevkey, outputs);
+                ApplyStats(stats, ss, muhash, hash_type, prevkey, outputs);
                 outputs.clear();
             }
             prevkey = key.hash;
@@ -751,51 +820,163 @@ static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats)
         pcursor->Next();
     }
     if (!outputs.empty()) {
-        ApplyStats(stats, ss, prevkey, outputs);
+        ApplyStats(stats, ss, muhash, hash_type, prevkey, outputs);
+    }
+    if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+        stats.hashSerialized = ss.GetHash();
+    } else if (hash_type == CoinStatsHashType::MUHASH) {
+        muhash.muhash.Finalize(stats.hashSerialized);
     }
-    stats.hashSerialized = ss.GetHash();
     stats.nDiskSize = view->EstimateSize();
     return true;
 }
 
 UniValue gettxoutsetinfo(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() != 0)
+    if (request.fHelp || request.params.size() > 2)
         throw std::runtime_error(
-            "gettxoutsetinfo\n"
+            "gettxoutsetinfo ( \"hash_type\" hash_or_height )\n"
             "\nReturns statistics about the unspent transaction output set.\n"
-            "Note this call may take some time.\n"
+            "Note this call may take some time, unless the node runs with -coinstatsindex and hash_type is not hash_serialized_2.\n"
+
+            "\nArguments:\n"
+            "1. \"hash_type\"      (string, optional, default=hash_serialized_2) Which UTXO set hash should be calculated.\n"
+            "                       Options: 'hash_serialized_2' (the legacy algorithm, only for the current tip), 'muhash', 'none'.\n"
+            "2. hash_or_height     (string or numeric, optional) The block hash or height of the target block, instead of the tip.\n"
+            "                       Requires -coinstatsindex.\n"
 
             "\nResult:\n"
             "{\n"
             "  \"height\":n,     (numeric) The current block height (index)\n"
             "  \"bestblock\": \"hex\",   (string) the best block hash hex\n"
-            "  \"transactions\": n,      (numeric) The number of transactions\n"
+            "  \"transactions\": n,      (numeric) The number of transactions (not returned when read from -coinstatsindex)\n"
             "  \"txouts\": n,            (numeric) The number of output transactions\n"
-            "  \"hash_serialized_2\": \"hash\",   (string) The serialized hash\n"
-            "  \"disk_size\": n,         (numeric) The estimated size of the chainstate on disk\n"
-            "  \"total_amount\": x.xxx          (numeric) The total amount\n"
+            "  \"hash_serialized_2\": \"hash\",   (string) The serialized hash (only for hash_type=hash_serialized_2)\n"
+            "  \"muhash\": \"hash\",      (string) The order-independent MuHash of the set (only for hash_type=muhash)\n"
+            "  \"disk_size\": n,         (numeric) The estimated size of the chainstate on disk (not returned when read from -coinstatsindex)\n"
+            "  \"total_amount\": x.xxx,  (numeric) The total amount\n"
+            "  \"shielded_amount\": x.xxx (numeric) The value of the Sapling pool (only when read from -coinstatsindex)\n"
             "}\n"
 
             "\nExamples:\n" +
-            HelpExampleCli("gettxoutsetinfo", "") + HelpExampleRpc("gettxoutsetinfo", ""));
+            HelpExampleCli("gettxoutsetinfo", "") + HelpExampleCli("gettxoutsetinfo", "\"muhash\" 1000") +
+            HelpExampleRpc("gettxoutsetinfo", "") + HelpExampleRpc("gettxoutsetinfo", "\"none\", 1000"));
+
+    const std::string strHashType = request.params.size() > 0 && !request.params[0].isNull() ? request.params[0].get_str() : "hash_serialized_2";
+    CoinStatsHashType hash_type;
+    if (strHashType == "hash_serialized_2") {
+        hash_type = CoinStatsHashType::HASH_SERIALIZED;
+    } else if (strHashType == "muhash") {
+        hash_type = CoinStatsHashType::MUHASH;
+    } else if (strHashType == "none") {
+        hash_type = CoinStatsHashType::NONE;
+    } else {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("%s is not a valid hash_type", strHashType));
+    }
+
+    const CBlockIndex* pindex = nullptr;
+    if (request.params.size() > 1 && !request.params[1].isNull()) {
+        if (!g_coinStatsIndex) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Querying specific block heights requires -coinstatsindex");
+        }
+        if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "hash_serialized_2 hash type cannot be queried for a specific block");
+        }
+        LOCK(cs_main);
+        const UniValue& target = request.params[1];
+        if (target.isNum()) {
+            const int nHeight = target.get_int();
+            if (nHeight < 0 || nHeight > chainActive.Height()) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Target block height %d is out of range", nHeight));
+            }
+            pindex = chainActive[nHeight];
+        } else {
+            pindex = LookupBlockIndex(ParseHashV(target, "hash_or_height"));
+            if (!pindex) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+            }
+        }
+    }
 
     UniValue ret(UniValue::VOBJ);
 
+    if (g_coinStatsIndex && hash_type != CoinStatsHashType::HASH_SERIALIZED) {
+        if (!pindex) pindex = WITH_LOCK(cs_main, return chainActive.Tip(); );
+        CCoinStatsEntry entry;
+        if (!g_coinStatsIndex->LookUpStats(pindex, entry)) {
+            throw JSONRPCError(RPC_MISC_ERROR, strprintf("No coin statistics for block %s, it was not connected while -coinstatsindex was enabled", pindex->GetBlockHash().GetHex()));
+        }
+        ret.pushKV("height", (int64_t)entry.nHeight);
+        ret.pushKV("bestblock", pindex->GetBlockHash().GetHex());
+        ret.pushKV("txouts", (int64_t)entry.nTransactionOutputs);
+        if (hash_type == CoinStatsHashType::MUHASH) {
+            ret.pushKV("muhash", entry.hashMuHash.GetHex());
+        }
+        ret.pushKV("total_amount", ValueFromAmount(entry.nTotalAmount));
+        ret.pushKV("shielded_amount", ValueFromAmount(entry.nShieldedAmount));
+        return ret;
+    }
+
     CCoinsStats stats;
     FlushStateToDisk();
-    if (GetUTXOStats(pcoinsTip.get(), stats)) {
+    if (GetUTXOStats(pcoinsTip.get(), stats, hash_type)) {
         ret.pushKV("height", (int64_t)stats.nHeight);
         ret.pushKV("bestblock", stats.hashBlock.GetHex());
         ret.pushKV("transactions", (int64_t)stats.nTransactions);
         ret.pushKV("txouts", (int64_t)stats.nTransactionOutputs);
-        ret.pushKV("hash_serialized_2", stats.hashSerialized.GetHex());
+        if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+            ret.pushKV("hash_serialized_2", stats.hashSerialized.GetHex());
+        } else if (hash_type == CoinStatsHashType::MUHASH) {
+            ret.pushKV("muhash", stats.hashSerialized.GetHex());
+        }
         ret.pushKV("total_amount", ValueFromAmount(stats.nTotalAmount));
         ret.pushKV("disk_size", stats.nDiskSize);
     }
     return ret;
 }
 
+UniValue dumpchainstate(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "dumpchainstate \"filename\"\n"
+            "\nWrite a snapshot of the chainstate at the current tip (UTXO set, Sapling anchors and nullifiers,\n"
+            "deterministic masternode and LLMQ state) to a file, to be loaded by a new node with -loadchainstate.\n"
+            "Note this call may take some time.\n"
+
+            "\nArguments:\n"
+            "1. \"filename\"    (string, required) The snapshot file. A relative path is taken relative to the data directory.\n"
+
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": n,               (numeric) The height of the snapshot block\n"
+            "  \"bestblock\": \"hex\",        (string) The hash of the snapshot block\n"
+            "  \"coins_db_entries\": n,     (numeric) The number of chainstate database entries written\n"
+            "  \"evo_db_entries\": n,       (numeric) The number of evo database entries written\n"
+            "  \"content_hash\": \"hex\",     (string) The hash of the snapshot content\n"
+            "  \"path\": \"xxx\"              (string) The absolute path of the snapshot file\n"
+            "}\n"
+
+            "\nExamples:\n" +
+            HelpExampleCli("dumpchainstate", "\"snapshot.dat\"") + HelpExampleRpc("dumpchainstate", "\"snapshot.dat\""));
+
+    const fs::path path = AbsPathForConfigVal(fs::path(request.params[0].get_str()));
+    ChainstateSnapshotMetadata metadata;
+    std::string strError;
+    if (!DumpChainstateSnapshot(path, metadata, strError)) {
+        throw JSONRPCError(RPC_MISC_ERROR, strError);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", metadata.nHeight);
+    ret.pushKV("bestblock", metadata.hashBlock.GetHex());
+    ret.pushKV("coins_db_entries", (int64_t)metadata.nCoinsDBEntries);
+    ret.pushKV("evo_db_entries", (int64_t)metadata.nEvoDBEntries);
+    ret.pushKV("content_hash", metadata.hashContent.GetHex());
+    ret.pushKV("path", path.string());
+    return ret;
+}
+
 UniValue gettxout(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
@@ -1283,6 +1464,66 @@ void validaterange(const UniValue& params, int& heightStart, int& heightEnd, int
     }
 }
 
+UniValue getblocktraces(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 1)
+        throw std::runtime_error(
+            "getblocktraces ( count )\n"
+            "\nReturns the contents and per-stage validation timings of the most recently connected blocks,\n"
+            "most recent first. Up to -blocktracesize blocks are kept (default: " + std::to_string(DEFAULT_BLOCK_TRACE_SIZE) + ").\n"
+            "Stages checked on acceptance are 0 for blocks accepted before the last restart.\n"
+
+            "\nArguments:\n"
+            "1. count              (numeric, optional, default=10) Number of blocks to return\n"
+
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"hash\": \"hash\",                (string) The block hash\n"
+            "    \"height\": n,                   (numeric) The block height\n"
+            "    \"time\": ttt,                   (numeric) The time the block was connected, in seconds since epoch\n"
+            "    \"size\": n,                     (numeric) The block size in bytes\n"
+            "    \"tx\": n,                       (numeric) Number of transactions\n"
+            "    \"inputs\": n,                   (numeric) Number of transparent inputs\n"
+            "    \"outputs\": n,                  (numeric) Number of transparent outputs\n"
+            "    \"shielded_spends\": n,          (numeric) Number of Sapling spends\n"
+            "    \"shielded_outputs\": n,         (numeric) Number of Sapling outputs\n"
+            "    \"special_tx\": n,               (numeric) Number of special transactions\n"
+            "    \"stages_us\": {                 (json object) Time spent in each stage, in microseconds\n"
+            "      \"check_block\": n,            (numeric) CheckBlock, on acceptance and on connection\n"
+            "      \"contextual_check\": n,       (numeric) ContextualCheckBlock, without the Sapling proofs\n"
+            "      \"sapling_proofs\": n,         (numeric) Sapling proof and signature verification\n"
+            "      \"read_block\": n,             (numeric) Loading the block from disk\n"
+            "      \"prefetch_inputs\": n,        (numeric) Loading uncached inputs from the coins database on the prefetch threads\n"
+            "      \"connect_inputs\": n,         (numeric) Coins lookups, input checks and coins updates\n"
+            "      \"verify_scripts\": n,         (numeric) Waiting for the script verification threads\n"
+            "      \"special_tx\": n,             (numeric) Special transactions (EvoDB, masternode list, quorums)\n"
+            "      \"index\": n,                  (numeric) Undo data and transaction index writes\n"
+            "      \"flush\": n,                  (numeric) Coins view and EvoDB flush\n"
+            "      \"chainstate\": n,             (numeric) Writing the chainstate to disk, if needed\n"
+            "      \"post_connect\": n,           (numeric) Mempool and tip updates\n"
+            "      \"signals\": n,                (numeric) Validation interface notifications\n"
+            "      \"total\": n                   (numeric) Connection of the block, from reading to signals\n"
+            "    }\n"
+            "  },\n"
+            "  ...\n"
+            "]\n"
+
+            "\nExamples:\n" +
+            HelpExampleCli("getblocktraces", "") + HelpExampleCli("getblocktraces", "100") +
+            HelpExampleRpc("getblocktraces", "100"));
+
+    const int count = request.params.size() > 0 ? request.params[0].get_int() : 10;
+    if (count < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be non-negative");
+
+    UniValue ret(UniValue::VARR);
+    for (const BlockValidationTrace& trace : g_blockTraces.GetLatest(count)) {
+        ret.push_back(trace.ToJSON());
+    }
+    return ret;
+}
+
 UniValue getblockindexstats(const JSONRPCRequest& request) {
     if (request.fHelp || request.params.size() != 2)
         throw std::runtime_error(
@@ -1421,33 +1662,35 @@ UniValue getfeeinfo(const JSONRPCRequest& request)
 }
 
 static const CRPCCommand commands[] =
-{ //  category              name                      actor (function)         okSafe argNames
+{ //  category              name                      actor (function)         okSafe argNames (concurrent)
   //  --------------------- ------------------------  -----------------------  ------ --------
-    { "blockchain",         "getbestblockhash",       &getbestblockhash,       true,  {} },
-    { "blockchain",         "getbestsaplinganchor",   &getbestsaplinganchor,   true,  {} },
-    { "blockchain",         "getblock",               &getblock,               true,  {"blockhash","verbose"} },
-    { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      true,  {} },
-    { "blockchain",         "getblockcount",          &getblockcount,          true,  {} },
-    { "blockchain",         "getblockhash",           &getblockhash,           true,  {"height"} },
-    { "blockchain",         "getblockheader",         &getblockheader,         false, {"blockhash","verbose"} },
-    { "blockchain",         "getblockindexstats",     &getblockindexstats,     true,  {"height","range"} },
-    { "blockchain",         "getchaintips",           &getchaintips,           true,  {} },
-    { "blockchain",         "getdifficulty",          &getdifficulty,          true,  {} },
-    { "blockchain",         "getfeeinfo",             &getfeeinfo,             true,  {"blocks"} },
-    { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         true,  {} },
-    { "blockchain",         "getrawmempool",          &getrawmempool,          true,  {"verbose"} },
-    { "blockchain",         "getsupplyinfo",          &getsupplyinfo,          true,  {"force_update"} },
-    { "blockchain",         "gettxout",               &gettxout,               true,  {"txid","n","include_mempool"} },
-    { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        true,  {} },
-    { "blockchain",         "verifychain",            &verifychain,            true,  {"nblocks"} },
+    { "blockchain",         "dumpchainstate",         &dumpchainstate,         true,  {"filename"}, false },
+    { "blockchain",         "getbestblockhash",       &getbestblockhash,       true,  {}, true },
+    { "blockchain",         "getbestsaplinganchor",   &getbestsaplinganchor,   true,  {}, true },
+    { "blockchain",         "getblock",               &getblock,               true,  {"blockhash","verbose"}, true },
+    { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      true,  {}, true },
+    { "blockchain",         "getblockcount",          &getblockcount,          true,  {}, true },
+    { "blockchain",         "getblockhash",           &getblockhash,           true,  {"height"}, true },
+    { "blockchain",         "getblockheader",         &getblockheader,         false, {"blockhash","verbose"}, true },
+    { "blockchain",         "getblockindexstats",     &getblockindexstats,     true,  {"height","range"}, true },
+    { "blockchain",         "getblocktraces",         &getblocktraces,         true,  {"count"}, true },
+    { "blockchain",         "getchaintips",           &getchaintips,           true,  {}, true },
+    { "blockchain",         "getdifficulty",          &getdifficulty,          true,  {}, true },
+    { "blockchain",         "getfeeinfo",             &getfeeinfo,             true,  {"blocks"}, true },
+    { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         true,  {}, true },
+    { "blockchain",         "getrawmempool",          &getrawmempool,          true,  {"verbose"}, true },
+    { "blockchain",         "getsupplyinfo",          &getsupplyinfo,          true,  {"force_update"}, false },
+    { "blockchain",         "gettxout",               &gettxout,               true,  {"txid","n","include_mempool"}, true },
+    { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        true,  {"hash_type", "hash_or_height"}, false },
+    { "blockchain",         "verifychain",            &verifychain,            true,  {"nblocks"}, false },
 
     /* Not shown in help */
-    { "hidden",             "invalidateblock",        &invalidateblock,        true,  {"blockhash"} },
-    { "hidden",             "reconsiderblock",        &reconsiderblock,        true,  {"blockhash"} },
-    { "hidden",             "waitforblock",           &waitforblock,           true,  {"blockhash","timeout"} },
-    { "hidden",             "waitforblockheight",     &waitforblockheight,     true,  {"height","timeout"} },
-    { "hidden",             "waitfornewblock",        &waitfornewblock,        true,  {"timeout"} },
-    { "hidden",             "syncwithvalidationinterfacequeue", &syncwithvalidationinterfacequeue, true,  {} },
+    { "hidden",             "invalidateblock",        &invalidateblock,        true,  {"blockhash"}, false },
+    { "hidden",             "reconsiderblock",        &reconsiderblock,        true,  {"blockhash"}, false },
+    { "hidden",             "waitforblock",           &waitforblock,           true,  {"blockhash","timeout"}, false },
+    { "hidden",             "waitforblockheight",     &waitforblockheight,     true,  {"height","timeout"}, false },
+    { "hidden",             "waitfornewblock",        &waitfornewblock,        true,  {"timeout"}, false },
+    { "hidden",             "syncwithvalidationinterfacequeue", &syncwithvalidationinterfacequeue, true,  {}, false },
 
 
 };
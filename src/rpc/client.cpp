@@ -55,10 +55,13 @@ static const CRPCConvertParam vRPCConvertParams[] = {
     { "getblockheader", 1, "verbose" },
     { "getblockindexstats", 0, "height" },
     { "getblockindexstats", 1, "range" },
+    { "getblocktraces", 0, "count" },
     { "getblocktemplate", 0, "template_request" },
     { "getfeeinfo", 0, "blocks" },
     { "getshieldbalance", 1, "minconf" },
     { "getshieldbalance", 2, "include_watchonly" },
+    { "getlockstats", 0, "count" },
+    { "getlockstats", 1, "reset" },
     { "getminedcommitment", 0, "llmq_type" },
     { "getnetworkhashps", 0, "nblocks" },
     { "getnetworkhashps", 1, "height" },
@@ -73,6 +76,7 @@ static const CRPCConvertParam vRPCConvertParams[] = {
     { "gettransaction", 1, "include_watchonly" },
     { "gettxout", 1, "n" },
     { "gettxout", 2, "include_mempool" },
+    { "gettxoutsetinfo", 1, "hash_or_height" },
     { "importaddress", 2, "rescan" },
     { "importaddress", 3, "p2sh" },
     { "importmulti", 0, "requests" },
@@ -0,0 +1,101 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rpc/jsonstream.h"
+
+#include <assert.h>
+#include <univalue.h>
+
+CJSONStreamWriter::CJSONStreamWriter(FlushFn flushIn, size_t nFlushSizeIn) :
+    flush(std::move(flushIn)),
+    nFlushSize(nFlushSizeIn)
+{
+    buf.reserve(nFlushSize + 1024);
+}
+
+void CJSONStreamWriter::BeginValue()
+{
+    if (fAfterKey) {
+        fAfterKey = false;
+        return;
+    }
+    if (!vEmpty.empty()) {
+        if (!vEmpty.back()) buf += ',';
+        vEmpty.back() = false;
+    }
+}
+
+void CJSONStreamWriter::FlushIfNeeded()
+{
+    if (buf.size() >= nFlushSize) {
+        std::string chunk;
+        chunk.reserve(nFlushSize + 1024);
+        chunk.swap(buf);
+        flush(std::move(chunk));
+    }
+}
+
+void CJSONStreamWriter::BeginObject()
+{
+    BeginValue();
+    buf += '{';
+    vEmpty.push_back(true);
+}
+
+void CJSONStreamWriter::EndObject()
+{
+    assert(!vEmpty.empty() && !fAfterKey);
+    vEmpty.pop_back();
+    buf += '}';
+    FlushIfNeeded();
+}
+
+void CJSONStreamWriter::BeginArray()
+{
+    BeginValue();
+    buf += '[';
+    vEmpty.push_back(true);
+}
+
+void CJSONStreamWriter::EndArray()
+{
+    assert(!vEmpty.empty() && !fAfterKey);
+    vEmpty.pop_back();
+    buf += ']';
+    FlushIfNeeded();
+}
+
+void CJSONStreamWriter::Key(const std::string& key)
+{
+    assert(!vEmpty.empty() && !fAfterKey);
+    BeginValue();
+    // A string value writes out as its escaped, quoted form
+    buf += UniValue(key).write();
+    buf += ':';
+    fAfterKey = true;
+}
+
+void CJSONStreamWriter::Value(const UniValue& val)
+{
+    BeginValue();
+    buf += val.write();
+    FlushIfNeeded();
+}
+
+void CJSONStreamWriter::ObjectEntries(const UniValue& obj)
+{
+    const std::vector<std::string>& keys = obj.getKeys();
+    const std::vector<UniValue>& values = obj.getValues();
+    for (size_t i = 0; i < keys.size(); i++) {
+        KeyValue(keys[i], values[i]);
+    }
+}
+
+void CJSONStreamWriter::Finish()
+{
+    assert(vEmpty.empty() && !fAfterKey);
+    buf += '\n';
+    flush(std::move(buf));
+    buf.clear();
+}
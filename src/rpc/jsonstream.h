@@ -0,0 +1,71 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_RPC_JSONSTREAM_H
+#define BCZ_RPC_JSONSTREAM_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class UniValue;
+
+/**
+ * Incremental JSON writer. The document is produced token by token into a
+ * buffer that is handed to the flush function whenever it grows past the
+ * flush size, so large responses (e.g. a block with all its transactions,
+ * or the whole mempool) are sent as they are built instead of going through
+ * a complete UniValue tree first.
+ * Small subtrees can still be built as UniValue and written with Value().
+ * Output is compact, as produced by UniValue::write().
+ *
+ * Only the REST JSON endpoints stream. A JSON-RPC reply is a result/error
+ * envelope whose failures must go out as an error object with HTTP 500,
+ * which is no longer possible once part of the result has been sent; batch
+ * replies and the per-method latency stats also work on returned values.
+ * listtransactions and listunspent sort and page their whole result under
+ * cs_wallet before the first entry is known, so they gain nothing from it.
+ */
+class CJSONStreamWriter
+{
+public:
+    typedef std::function<void(std::string&&)> FlushFn;
+
+    static const size_t DEFAULT_FLUSH_SIZE = 64 * 1024;
+
+    explicit CJSONStreamWriter(FlushFn flushIn, size_t nFlushSizeIn = DEFAULT_FLUSH_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Write an object key. Must be followed by a value, or by an object or array. */
+    void Key(const std::string& key);
+    /** Write a complete value */
+    void Value(const UniValue& val);
+    void KeyValue(const std::string& key, const UniValue& val)
+    {
+        Key(key);
+        Value(val);
+    }
+    /** Write every key/value of obj into the current object */
+    void ObjectEntries(const UniValue& obj);
+
+    /** Terminate the document with a newline and flush what is left */
+    void Finish();
+
+private:
+    void BeginValue();
+    void FlushIfNeeded();
+
+    const FlushFn flush;
+    const size_t nFlushSize;
+    std::string buf;
+    //! One entry per open object or array: whether it is still empty
+    std::vector<bool> vEmpty;
+    bool fAfterKey{false};
+};
+
+#endif // BCZ_RPC_JSONSTREAM_H
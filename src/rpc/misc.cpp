@@ -16,6 +16,8 @@
 #include "tiertwo/net_masternodes.h"
 #include "rpc/server.h"
 #include "spork.h"
+#include "startupstages.h"
+#include "sync.h"
 #include "timedata.h"
 #include "tiertwo/tiertwo_sync_state.h"
 #include "util/system.h"
@@ -732,6 +734,121 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
     return obj;
 }
 
+static UniValue LockBucketsToJSON(const std::vector<uint64_t>& vBuckets)
+{
+    // Only the non-empty buckets, keyed by their upper bound
+    UniValue obj(UniValue::VOBJ);
+    for (size_t i = 0; i < vBuckets.size(); i++) {
+        if (vBuckets[i] == 0) continue;
+        const std::string strKey = i + 1 < vBuckets.size() ? strprintf("lt_%uus", 1ULL << i) : strprintf("ge_%uus", 1ULL << (i - 1));
+        obj.pushKV(strKey, vBuckets[i]);
+    }
+    return obj;
+}
+
+UniValue getlockstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 2)
+        throw std::runtime_error(
+            "getlockstats ( count reset )\n"
+            "Returns wait and hold times of the profiled locks (cs_main, mempool.cs, cs_wallet,\n"
+            "deterministicMNManager.cs and the connection manager locks) at each place they are taken,\n"
+            "sorted by total hold time.\n"
+            "\nArguments:\n"
+            "1. count    (numeric, optional, default=20) Number of sites to return, 0 for all\n"
+            "2. reset    (boolean, optional, default=false) Start the counters over after reading them\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"dropped_sites\": n,            (numeric) Sites not profiled because the table is full\n"
+            "  \"sites\": [\n"
+            "    {\n"
+            "      \"lock\": \"name\",            (string) The lock\n"
+            "      \"location\": \"file:line\",     (string) Where it is taken\n"
+            "      \"acquired\": n,               (numeric) Times it was taken\n"
+            "      \"contended\": n,              (numeric) Times it had to be waited for\n"
+            "      \"wait_total_ms\": x.xxx,      (numeric) Total time spent waiting\n"
+            "      \"wait_max_ms\": x.xxx,        (numeric) Longest wait\n"
+            "      \"hold_total_ms\": x.xxx,      (numeric) Total time held\n"
+            "      \"hold_max_ms\": x.xxx,        (numeric) Longest hold\n"
+            "      \"wait_histogram\": { \"lt_<n>us\": n, ... },  (json object) Contended waits by duration\n"
+            "      \"hold_histogram\": { \"lt_<n>us\": n, ... }   (json object) Holds by duration\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getlockstats", "")
+            + HelpExampleCli("getlockstats", "0 true")
+            + HelpExampleRpc("getlockstats", "10")
+        );
+
+    const int nCount = request.params.size() > 0 ? request.params[0].get_int() : 20;
+    if (nCount < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive or 0");
+    const bool fReset = request.params.size() > 1 && request.params[1].get_bool();
+
+    std::vector<LockSiteProfile> vProfile = GetLockProfile();
+    if (fReset) ResetLockProfile();
+
+    UniValue sites(UniValue::VARR);
+    for (const LockSiteProfile& site : vProfile) {
+        if (nCount > 0 && sites.size() >= (size_t)nCount) break;
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("lock", site.strMutex);
+        obj.pushKV("location", strprintf("%s:%d", site.strFile, site.nLine));
+        obj.pushKV("acquired", site.nAcquired);
+        obj.pushKV("contended", site.nContended);
+        obj.pushKV("wait_total_ms", site.nWaitNanos * 1e-6);
+        obj.pushKV("wait_max_ms", site.nMaxWaitNanos * 1e-6);
+        obj.pushKV("hold_total_ms", site.nHoldNanos * 1e-6);
+        obj.pushKV("hold_max_ms", site.nMaxHoldNanos * 1e-6);
+        obj.pushKV("wait_histogram", LockBucketsToJSON(site.vWaitBuckets));
+        obj.pushKV("hold_histogram", LockBucketsToJSON(site.vHoldBuckets));
+        sites.push_back(obj);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("dropped_sites", GetLockProfileDroppedSites());
+    ret.pushKV("sites", sites);
+    return ret;
+}
+
+UniValue getstartupinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || !request.params.empty())
+        throw std::runtime_error(
+            "getstartupinfo\n"
+            "Returns the timings of the node startup stages. Background stages ran on their own thread,\n"
+            "alongside the stages that started after them.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"ready_ms\": n,                 (numeric) Time from the process start until the node was ready\n"
+            "  \"stages\": [\n"
+            "    {\n"
+            "      \"name\": \"name\",            (string) The stage (block_index, wallet_db, wallet, sapling_params, ...)\n"
+            "      \"background\": true|false,  (boolean) Whether it ran on its own thread\n"
+            "      \"start_ms\": n,             (numeric) Time from the process start until the stage started\n"
+            "      \"duration_ms\": n,          (numeric) Time the stage took, if it completed\n"
+            "      \"success\": true|false,     (boolean) Whether it succeeded, if it completed\n"
+            "      \"running\": true            (boolean) Present while the stage is still running\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getstartupinfo", "")
+            + HelpExampleRpc("getstartupinfo", "")
+        );
+
+    UniValue stages(UniValue::VARR);
+    for (const StartupStage& stage : g_startupStages.GetStages()) {
+        stages.push_back(stage.ToJSON());
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("ready_ms", g_startupStages.GetReadyTime());
+    ret.pushKV("stages", stages);
+    return ret;
+}
+
 UniValue echo(const JSONRPCRequest& request)
 {
     if (request.fHelp)
@@ -826,7 +943,9 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         okSafe argNames
   //  --------------------- ------------------------  -----------------------  ------ --------
     { "control",            "getinfo",                &getinfo,                true,  {} }, /* uses wallet if enabled */
+    { "control",            "getlockstats",           &getlockstats,           true,  {"count","reset"} },
     { "control",            "getmemoryinfo",          &getmemoryinfo,          true,  {} },
+    { "control",            "getstartupinfo",         &getstartupinfo,         true,  {} },
     { "control",            "mnsync",                 &mnsync,                 true,  {"mode"} },
     { "control",            "spork",                  &spork,                  true,  {"name","value"} },
 
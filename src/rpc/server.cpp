@@ -7,6 +7,7 @@
 
 #include "rpc/server.h"
 
+#include "ctpl_stl.h"
 #include "fs.h"
 #include "key_io.h"
 #include "random.h"
@@ -14,6 +15,7 @@
 #include "sync.h"
 #include "guiinterface.h"
 #include "util/system.h"
+#include "util/threadnames.h"
 #include "utilstrencodings.h"
 
 #ifdef ENABLE_WALLET
@@ -23,7 +25,9 @@
 #include <boost/signals2/signal.hpp>
 #include <boost/thread.hpp>
 
-#include <memory> // for unique_ptr
+#include <array>
+#include <atomic>
+#include <memory> // for unique_ptr, shared_ptr
 #include <unordered_map>
 
 static bool fRPCRunning = false;
@@ -36,6 +40,39 @@ static RPCTimerInterface* timerInterface = NULL;
 /* Map of name to timer. */
 static std::map<std::string, std::unique_ptr<RPCTimerBase>> deadlineTimers;
 
+/* Threads running the concurrent elements of batch requests */
+static Mutex cs_batchPool;
+//! Batches take a reference for as long as they use the pool, so that StopRPC can run while they finish
+static std::shared_ptr<ctpl::thread_pool> batchPool GUARDED_BY(cs_batchPool);
+static const int DEFAULT_RPC_BATCH_THREADS = 4;
+
+/* Upper bounds of the latency histogram buckets, in microseconds (plus an open ended last bucket) */
+static const int64_t RPC_LATENCY_BUCKETS[] = {100, 1000, 10000, 100000, 1000000, 10000000};
+
+struct RPCMethodStats
+{
+    uint64_t nCalls{0};
+    uint64_t nErrors{0};
+    int64_t nTotalMicros{0};
+    int64_t nMaxMicros{0};
+    std::array<uint64_t, ARRAYLEN(RPC_LATENCY_BUCKETS) + 1> vBuckets{};
+};
+static Mutex cs_rpcStats;
+static std::map<std::string, RPCMethodStats> mapRPCStats GUARDED_BY(cs_rpcStats);
+
+static void RecordRPCLatency(const std::string& strMethod, int64_t nMicros, bool fError)
+{
+    size_t nBucket = 0;
+    while (nBucket < ARRAYLEN(RPC_LATENCY_BUCKETS) && nMicros > RPC_LATENCY_BUCKETS[nBucket]) nBucket++;
+    LOCK(cs_rpcStats);
+    RPCMethodStats& stats = mapRPCStats[strMethod];
+    stats.nCalls++;
+    if (fError) stats.nErrors++;
+    stats.nTotalMicros += nMicros;
+    stats.nMaxMicros = std::max(stats.nMaxMicros, nMicros);
+    stats.vBuckets[nBucket]++;
+}
+
 static struct CRPCSignals
 {
     boost::signals2::signal<void ()> Started;
@@ -257,6 +294,54 @@ UniValue help(const JSONRPCRequest& jsonRequest)
 }
 
 
+UniValue getrpcstats(const JSONRPCRequest& jsonRequest)
+{
+    if (jsonRequest.fHelp || !jsonRequest.params.empty())
+        throw std::runtime_error(
+            "getrpcstats\n"
+            "\nReturns call counts and latency histograms of the RPC methods called since startup.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"method\": {              (object) statistics of an RPC method\n"
+            "    \"calls\": n,            (numeric) number of calls\n"
+            "    \"errors\": n,           (numeric) number of calls that returned an error\n"
+            "    \"total_ms\": x.xxx,     (numeric) total time spent in the method\n"
+            "    \"mean_ms\": x.xxx,      (numeric) mean time per call\n"
+            "    \"max_ms\": x.xxx,       (numeric) slowest call\n"
+            "    \"histogram\": {         (object) number of calls by latency\n"
+            "      \"le_0.1ms\": n,       (numeric) calls that took at most 0.1 ms\n"
+            "      ...\n"
+            "      \"gt_10000ms\": n      (numeric) calls that took more than 10 s\n"
+            "    }\n"
+            "  }, ...\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getrpcstats", "")
+            + HelpExampleRpc("getrpcstats", ""));
+
+    std::map<std::string, RPCMethodStats> mapStats = WITH_LOCK(cs_rpcStats, return mapRPCStats; );
+
+    UniValue ret(UniValue::VOBJ);
+    for (const auto& it : mapStats) {
+        const RPCMethodStats& stats = it.second;
+        UniValue histogram(UniValue::VOBJ);
+        for (size_t i = 0; i < stats.vBuckets.size(); i++) {
+            const bool fLast = i == ARRAYLEN(RPC_LATENCY_BUCKETS);
+            const int64_t nBound = RPC_LATENCY_BUCKETS[fLast ? i - 1 : i];
+            histogram.pushKV(strprintf("%s_%gms", fLast ? "gt" : "le", nBound * 0.001), stats.vBuckets[i]);
+        }
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("calls", stats.nCalls);
+        obj.pushKV("errors", stats.nErrors);
+        obj.pushKV("total_ms", stats.nTotalMicros * 0.001);
+        obj.pushKV("mean_ms", stats.nTotalMicros * 0.001 / stats.nCalls);
+        obj.pushKV("max_ms", stats.nMaxMicros * 0.001);
+        obj.pushKV("histogram", histogram);
+        ret.pushKV(it.first, obj);
+    }
+    return ret;
+}
+
 UniValue stop(const JSONRPCRequest& jsonRequest)
 {
     if (jsonRequest.fHelp || !jsonRequest.params.empty())
@@ -278,6 +363,7 @@ static const CRPCCommand vRPCCommands[] =
   //  category              name                      actor (function)         okSafe argNames
   //  --------------------- ------------------------  -----------------------  ------ ----------
     /* Overall control/query calls */
+    { "control",            "getrpcstats",            &getrpcstats,            true,  {}  },
     { "control",            "help",                   &help,                   true,  {"command"}  },
     { "control",            "stop",                   &stop,                   true,  {}  },
 };
@@ -318,6 +404,10 @@ bool CRPCTable::appendCommand(const std::string& name, const CRPCCommand* pcmd)
 bool StartRPC()
 {
     LogPrint(BCLog::RPC, "Starting RPC\n");
+    const int nBatchThreads = std::max((int)gArgs.GetArg("-rpcthreads", DEFAULT_RPC_BATCH_THREADS), 1);
+    auto pool = std::make_shared<ctpl::thread_pool>(nBatchThreads);
+    RenameThreadPool(*pool, "bcz-rpcbatch");
+    WITH_LOCK(cs_batchPool, batchPool = std::move(pool); );
     fRPCRunning = true;
     g_rpcSignals.Started();
     return true;
@@ -333,6 +423,11 @@ void InterruptRPC()
 void StopRPC()
 {
     LogPrint(BCLog::RPC, "Stopping RPC\n");
+    std::shared_ptr<ctpl::thread_pool> pool;
+    WITH_LOCK(cs_batchPool, pool.swap(batchPool); );
+    // The batches still running on the HTTP workers hold their own reference: the
+    // last one to drop it stops the threads, once its requests are done
+    pool.reset();
     deadlineTimers.clear();
     DeleteAuthCookie();
     g_rpcSignals.Stopped();
@@ -421,11 +516,55 @@ static UniValue JSONRPCExecOne(const UniValue& req)
     return rpc_result;
 }
 
+static bool IsConcurrentBatchRequest(const UniValue& req)
+{
+    if (!req.isObject()) return false;
+    const UniValue& valMethod = find_value(req, "method");
+    if (!valMethod.isStr()) return false;
+    const CRPCCommand* pcmd = tableRPC[valMethod.get_str()];
+    return pcmd && pcmd->fConcurrentBatch;
+}
+
+/** Run the requests [nBegin, nEnd) on the batch threads, with the calling thread helping out */
+static void JSONRPCExecConcurrent(ctpl::thread_pool& pool, const UniValue& vReq, size_t nBegin, size_t nEnd, std::vector<UniValue>& vReplies)
+{
+    std::atomic<size_t> nNext{nBegin};
+    const auto work = [&]() {
+        for (size_t i = nNext++; i < nEnd; i = nNext++) {
+            vReplies[i] = JSONRPCExecOne(vReq[i]);
+        }
+    };
+    std::vector<std::future<void>> vHelpers;
+    const size_t nHelpers = std::min((size_t)pool.size(), nEnd - nBegin - 1);
+    for (size_t i = 0; i < nHelpers; i++) {
+        vHelpers.emplace_back(pool.push([&work](int) { work(); }));
+    }
+    work();
+    for (auto& f : vHelpers) f.wait();
+}
+
 std::string JSONRPCExecBatch(const UniValue& vReq)
 {
+    std::vector<UniValue> vReplies(vReq.size());
+    const std::shared_ptr<ctpl::thread_pool> pool = WITH_LOCK(cs_batchPool, return batchPool; );
+    size_t reqIdx = 0;
+    while (reqIdx < vReq.size()) {
+        // A run of consecutive concurrent requests is executed in parallel, anything else
+        // runs alone after the requests before it, so the batch keeps its ordering.
+        size_t nEnd = reqIdx;
+        while (pool && nEnd < vReq.size() && IsConcurrentBatchRequest(vReq[nEnd])) nEnd++;
+        if (nEnd - reqIdx > 1) {
+            JSONRPCExecConcurrent(*pool, vReq, reqIdx, nEnd, vReplies);
+            reqIdx = nEnd;
+        } else {
+            vReplies[reqIdx] = JSONRPCExecOne(vReq[reqIdx]);
+            reqIdx++;
+        }
+    }
+
     UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(vReq[reqIdx]));
+    for (const UniValue& reply : vReplies)
+        ret.push_back(reply);
 
     return ret.write() + "\n";
 }
@@ -487,13 +626,24 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
 
     g_rpcSignals.PreCommand(*pcmd);
 
+    // Record the latency of every call, failed ones included
+    struct LatencyRecorder {
+        const std::string& strMethod;
+        const int64_t nStart;
+        bool fError;
+        ~LatencyRecorder() { RecordRPCLatency(strMethod, GetTimeMicros() - nStart, fError); }
+    } recorder{pcmd->name, GetTimeMicros(), true};
+
     try {
         // Execute, convert arguments to array if necessary
+        UniValue result;
         if (request.params.isObject()) {
-            return pcmd->actor(transformNamedArguments(request, pcmd->argNames));
+            result = pcmd->actor(transformNamedArguments(request, pcmd->argNames));
         } else {
-            return pcmd->actor(request);
+            result = pcmd->actor(request);
         }
+        recorder.fError = false;
+        return result;
     } catch (const std::exception& e) {
         throw JSONRPCError(RPC_MISC_ERROR, e.what());
     }
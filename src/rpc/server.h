@@ -137,6 +137,9 @@ public:
     rpcfn_type actor;
     bool okSafeMode;
     std::vector<std::string> argNames;
+    //! Elements of a JSON-RPC batch calling this method may run concurrently with each other:
+    //! set for methods that don't change state, so the order inside the batch doesn't matter
+    bool fConcurrentBatch{false};
 };
 
 /**
@@ -199,6 +202,10 @@ extern std::string HelpExampleRpc(std::string methodname, std::string args);
 bool StartRPC();
 void InterruptRPC();
 void StopRPC();
+/**
+ * Execute a batch of requests, returning the replies in request order.
+ * Consecutive requests of fConcurrentBatch methods run in parallel.
+ */
 std::string JSONRPCExecBatch(const UniValue& vReq);
 void RPCNotifyBlockChange(bool fInitialDownload, const CBlockIndex* pindex);
 
@@ -133,6 +133,15 @@ extern "C" {
     /// `librustzcash_sapling_proving_ctx_init`.
     void librustzcash_sapling_proving_ctx_free(void *);
 
+    /// Adds the value commitments and their randomness accumulated
+    /// by `other` to `ctx`, so that proofs created with several
+    /// contexts (e.g. one per thread) can share one binding signature.
+    /// `other` is left untouched and must still be freed.
+    void librustzcash_sapling_proving_ctx_merge(
+        void *ctx,
+        const void *other
+    );
+
     /// Creates a Sapling verification context. Please free this
     /// when you're done.
     void * librustzcash_sapling_verification_ctx_init();
@@ -3,7 +3,7 @@
 
 use lazy_static;
 
-use ff::{PrimeField, PrimeFieldRepr};
+use ff::{Field, PrimeField, PrimeFieldRepr};
 use pairing::bls12_381::{Bls12, Fr, FrRepr};
 
 use zcash_primitives::{
@@ -11,11 +11,11 @@ use zcash_primitives::{
     jubjub::{
         edwards,
         fs::{Fs, FsRepr},
-        FixedGenerators, JubjubEngine, JubjubParams, PrimeOrder, ToUniform, Unknown,
+        FixedGenerators, JubjubBls12, JubjubEngine, JubjubParams, PrimeOrder, ToUniform, Unknown,
     },
 };
 
-use zcash_proofs::circuit::sapling::TREE_DEPTH as SAPLING_TREE_DEPTH;
+use zcash_proofs::circuit::sapling::{Output, Spend, TREE_DEPTH as SAPLING_TREE_DEPTH};
 use zcash_proofs::circuit::sprout::{self, TREE_DEPTH as SPROUT_TREE_DEPTH};
 
 use bellman::gadgets::multipack;
@@ -50,15 +50,15 @@ use zcash_primitives::{
     block::equihash,
     merkle_tree::CommitmentTreeWitness,
     note_encryption::sapling_ka_agree,
-    primitives::{Diversifier, Note, PaymentAddress, ProofGenerationKey, ViewingKey},
+    primitives::{Diversifier, Note, PaymentAddress, ProofGenerationKey, ValueCommitment, ViewingKey},
     redjubjub::{self, Signature},
-    sapling::{merkle_hash, spend_sig},
+    sapling::{merkle_hash, spend_sig, Node},
     transaction::components::Amount,
     zip32, JUBJUB,
 };
 use zcash_proofs::{
     load_parameters,
-    sapling::{SaplingProvingContext, SaplingVerificationContext},
+    sapling::SaplingVerificationContext,
 };
 
 #[cfg(test)]
@@ -925,6 +925,179 @@ pub extern "system" fn librustzcash_sprout_verify(
     }
 }
 
+/// Sapling proving context. It creates the same proofs as the one in
+/// `zcash_proofs`, but the sums it accumulates for the binding signature
+/// can be merged, so that the proofs of a transaction can be created with
+/// one context per thread.
+pub struct SaplingProvingContext {
+    // Sum of the Spend value commitment randomness minus the Output ones
+    bsk: Fs,
+    // Sum of the Spend value commitments minus the Output ones
+    cv_sum: edwards::Point<Bls12, Unknown>,
+}
+
+impl SaplingProvingContext {
+    fn new() -> Self {
+        SaplingProvingContext {
+            bsk: Fs::zero(),
+            cv_sum: edwards::Point::zero(),
+        }
+    }
+
+    fn spend_proof(
+        &mut self,
+        proof_generation_key: ProofGenerationKey<Bls12>,
+        diversifier: Diversifier,
+        rcm: Fs,
+        ar: Fs,
+        value: u64,
+        anchor: Fr,
+        witness: CommitmentTreeWitness<Node>,
+        proving_key: &Parameters<Bls12>,
+        params: &JubjubBls12,
+    ) -> Result<(Proof<Bls12>, edwards::Point<Bls12, Unknown>, redjubjub::PublicKey<Bls12>), ()> {
+        let mut rng = OsRng;
+
+        // Value commitment, with fresh randomness
+        let rcv = Fs::random(&mut rng);
+        let value_commitment = ValueCommitment::<Bls12> {
+            value,
+            randomness: rcv,
+        };
+
+        // Payment address of the note being spent
+        let viewing_key = proof_generation_key.to_viewing_key(params);
+        let payment_address = match viewing_key.into_payment_address(diversifier, params) {
+            Some(p) => p,
+            None => return Err(()),
+        };
+
+        // Re-randomized spend validating key, computed for the caller
+        let rk = redjubjub::PublicKey::<Bls12>(proof_generation_key.ak.clone().into()).randomize(
+            ar,
+            FixedGenerators::SpendingKeyGenerator,
+            params,
+        );
+
+        let instance = Spend {
+            params,
+            value_commitment: Some(value_commitment.clone()),
+            proof_generation_key: Some(proof_generation_key),
+            payment_address: Some(payment_address),
+            commitment_randomness: Some(rcm),
+            ar: Some(ar),
+            auth_path: witness
+                .auth_path
+                .iter()
+                .map(|n| n.map(|(node, b)| (node.into(), b)))
+                .collect(),
+            anchor: Some(anchor),
+        };
+        let proof = match create_random_proof(instance, proving_key, &mut rng) {
+            Ok(p) => p,
+            Err(_) => return Err(()),
+        };
+
+        let cv: edwards::Point<Bls12, Unknown> = value_commitment.cm(params).into();
+        self.bsk.add_assign(&rcv);
+        self.cv_sum = self.cv_sum.add(&cv, params);
+
+        Ok((proof, cv, rk))
+    }
+
+    fn output_proof(
+        &mut self,
+        esk: Fs,
+        payment_address: PaymentAddress<Bls12>,
+        rcm: Fs,
+        value: u64,
+        proving_key: &Parameters<Bls12>,
+        params: &JubjubBls12,
+    ) -> Result<(Proof<Bls12>, edwards::Point<Bls12, Unknown>), ()> {
+        let mut rng = OsRng;
+
+        // Value commitment, with fresh randomness
+        let rcv = Fs::random(&mut rng);
+        let value_commitment = ValueCommitment::<Bls12> {
+            value,
+            randomness: rcv,
+        };
+
+        let instance = Output {
+            params,
+            value_commitment: Some(value_commitment.clone()),
+            payment_address: Some(payment_address),
+            commitment_randomness: Some(rcm),
+            esk: Some(esk),
+        };
+        let proof = match create_random_proof(instance, proving_key, &mut rng) {
+            Ok(p) => p,
+            Err(_) => return Err(()),
+        };
+
+        // Outputs subtract from the sums
+        let cv: edwards::Point<Bls12, Unknown> = value_commitment.cm(params).into();
+        self.bsk.sub_assign(&rcv);
+        self.cv_sum = self.cv_sum.add(&cv.negate(), params);
+
+        Ok((proof, cv))
+    }
+
+    fn merge(&mut self, other: &SaplingProvingContext, params: &JubjubBls12) {
+        self.bsk.add_assign(&other.bsk);
+        self.cv_sum = self.cv_sum.add(&other.cv_sum, params);
+    }
+
+    fn binding_sig(
+        &self,
+        value_balance: Amount,
+        sighash: &[u8; 32],
+        params: &JubjubBls12,
+    ) -> Result<Signature, ()> {
+        let mut rng = OsRng;
+
+        let bsk = redjubjub::PrivateKey::<Bls12>(self.bsk);
+        let bvk = redjubjub::PublicKey::from_private(
+            &bsk,
+            FixedGenerators::ValueCommitmentRandomness,
+            params,
+        );
+
+        // The value commitments, less the value balance, must be a commitment
+        // to zero under bsk, or the transaction would not balance.
+        {
+            let abs = match i64::from(value_balance).checked_abs() {
+                Some(a) => a as u64,
+                None => return Err(()),
+            };
+            let mut balance = params
+                .generator(FixedGenerators::ValueCommitmentValue)
+                .mul(FsRepr::from(abs), params);
+            if value_balance.is_negative() {
+                balance = balance.negate();
+            }
+            let balance: edwards::Point<Bls12, Unknown> = balance.into();
+            if self.cv_sum.add(&balance.negate(), params) != bvk.0 {
+                return Err(());
+            }
+        }
+
+        // The binding signature signs bvk || sighash
+        let mut data_to_be_signed = [0u8; 64];
+        bvk.0
+            .write(&mut data_to_be_signed[0..32])
+            .expect("message buffer should be 32 bytes");
+        (&mut data_to_be_signed[32..64]).copy_from_slice(&sighash[..]);
+
+        Ok(bsk.sign(
+            &data_to_be_signed,
+            &mut rng,
+            FixedGenerators::ValueCommitmentRandomness,
+            params,
+        ))
+    }
+}
+
 #[no_mangle]
 pub extern "system" fn librustzcash_sapling_output_proof(
     ctx: *mut SaplingProvingContext,
@@ -955,14 +1128,17 @@ pub extern "system" fn librustzcash_sapling_output_proof(
     };
 
     // Create proof
-    let (proof, value_commitment) = unsafe { &mut *ctx }.output_proof(
+    let (proof, value_commitment) = match unsafe { &mut *ctx }.output_proof(
         esk,
         payment_address,
         rcm,
         value,
         unsafe { SAPLING_OUTPUT_PARAMS.as_ref() }.unwrap(),
         &JUBJUB,
-    );
+    ) {
+        Ok(r) => r,
+        Err(_) => return false,
+    };
 
     // Write the proof out to the caller
     proof
@@ -1102,20 +1278,20 @@ pub extern "system" fn librustzcash_sapling_spend_proof(
     };
 
     // Create proof
-    let (proof, value_commitment, rk) = unsafe { &mut *ctx }
-        .spend_proof(
-            proof_generation_key,
-            diversifier,
-            rcm,
-            ar,
-            value,
-            anchor,
-            witness,
-            unsafe { SAPLING_SPEND_PARAMS.as_ref() }.unwrap(),
-            unsafe { SAPLING_SPEND_VK.as_ref() }.unwrap(),
-            &JUBJUB,
-        )
-        .expect("proving should not fail");
+    let (proof, value_commitment, rk) = match unsafe { &mut *ctx }.spend_proof(
+        proof_generation_key,
+        diversifier,
+        rcm,
+        ar,
+        value,
+        anchor,
+        witness,
+        unsafe { SAPLING_SPEND_PARAMS.as_ref() }.unwrap(),
+        &JUBJUB,
+    ) {
+        Ok(r) => r,
+        Err(_) => return false,
+    };
 
     // Write value commitment to caller
     value_commitment
@@ -1146,6 +1322,14 @@ pub extern "system" fn librustzcash_sapling_proving_ctx_free(ctx: *mut SaplingPr
     drop(unsafe { Box::from_raw(ctx) });
 }
 
+#[no_mangle]
+pub extern "system" fn librustzcash_sapling_proving_ctx_merge(
+    ctx: *mut SaplingProvingContext,
+    other: *const SaplingProvingContext,
+) {
+    unsafe { &mut *ctx }.merge(unsafe { &*other }, &JUBJUB);
+}
+
 #[no_mangle]
 pub extern "system" fn librustzcash_zip32_xsk_master(
     seed: *const c_uchar,
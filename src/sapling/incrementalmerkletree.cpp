@@ -7,6 +7,9 @@
 
 #include "crypto/sha256.h"
 #include "sapling/incrementalmerkletree.h"
+#include "util/parallel.h"
+
+#include <algorithm>
 
 #include <librustzcash.h>
 
@@ -925,6 +928,8 @@ void IncrementalMerkleTree<Depth, Hash>::append(Hash obj) {
         throw std::runtime_error("tree is full");
     }
 
+    cached_root = nullopt;
+
     if (!left) {
         // Set the left leaf
         left = obj;
@@ -956,6 +961,74 @@ void IncrementalMerkleTree<Depth, Hash>::append(Hash obj) {
     }
 }
 
+// Below this many pairs a level is not worth spreading over the workers
+static const size_t MIN_PAIRS_PER_THREAD = 16;
+
+// Hash the pairs of nodes [(in[0], in[1]), (in[2], in[3]), ...] at depth
+template<typename Hash>
+static std::vector<Hash> CombinePairs(const std::vector<Hash>& in, size_t depth)
+{
+    const size_t nPairs = in.size() / 2;
+    std::vector<Hash> out(nPairs);
+    auto combineRange = [&in, &out, depth](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            out[i] = Hash::combine(in[2 * i], in[2 * i + 1], depth);
+        }
+    };
+
+    ParallelForRanges(nPairs, MIN_PAIRS_PER_THREAD, combineRange);
+    return out;
+}
+
+template<size_t Depth, typename Hash>
+void IncrementalMerkleTree<Depth, Hash>::append_batch(const std::vector<Hash>& objs) {
+    if (objs.empty()) {
+        return;
+    }
+    if (Depth < 64 && objs.size() > ((uint64_t)1 << Depth) - size()) {
+        throw std::runtime_error("tree is full");
+    }
+
+    cached_root = nullopt;
+
+    // Leaves: the last one, or two when their count is even, stay as
+    // left/right (append only combines them once a further leaf comes),
+    // all the others are hashed in pairs.
+    std::vector<Hash> level;
+    level.reserve(objs.size() + 2);
+    if (left) level.push_back(*left);
+    if (right) level.push_back(*right);
+    level.insert(level.end(), objs.begin(), objs.end());
+
+    const size_t nKeep = (level.size() % 2) ? 1 : 2;
+    right = nullopt;
+    if (nKeep == 2) right = level.back();
+    left = level[level.size() - nKeep];
+    level.resize(level.size() - nKeep);
+
+    // Complete nodes at depth d+1: pair them up with the pending left
+    // sibling in parents[d], an odd one out becomes the new parents[d].
+    std::vector<Hash> nodes = CombinePairs(level, 0);
+    for (size_t d = 0; !nodes.empty(); d++) {
+        level.clear();
+        if (d < parents.size() && parents[d]) level.push_back(*parents[d]);
+        level.insert(level.end(), nodes.begin(), nodes.end());
+
+        Optional<Hash> pending;
+        if (level.size() % 2) {
+            pending = level.back();
+            level.pop_back();
+        }
+        if (pending && d >= parents.size()) {
+            parents.resize(d + 1);
+        }
+        if (d < parents.size()) {
+            parents[d] = pending;
+        }
+        nodes = CombinePairs(level, d + 1);
+    }
+}
+
 // This is for allowing the witness to determine if a subtree has filled
 // to a particular depth, or for append() to ensure we're not appending
 // to a full tree.
@@ -15,6 +15,7 @@
 
 #include <array>
 #include <deque>
+#include <vector>
 
 namespace libzcash {
 
@@ -103,8 +104,23 @@ public:
     size_t size() const;
 
     void append(Hash obj);
+    // Append a block worth of leaves, hashing each level of the new
+    // subtrees at once (in parallel when it is wide enough). Same result
+    // as appending them one by one.
+    void append_batch(const std::vector<Hash>& objs);
+
+    // The root is memoized until the next append: a tree is read and
+    // pushed as anchor for every block, most of which add no leaves.
     Hash root() const {
-        return root(Depth, std::deque<Hash>());
+        if (!cached_root) {
+            cached_root = root(Depth, std::deque<Hash>());
+        }
+        return *cached_root;
+    }
+    // Seed the memoized root with a known value, such as the anchor key
+    // the tree was read under.
+    void set_cached_root(const Hash& rt) const {
+        cached_root = rt;
     }
     Hash last() const;
 
@@ -115,6 +131,7 @@ public:
     SERIALIZE_METHODS(IncrementalMerkleTree, obj)
     {
         READWRITE(obj.left, obj.right, obj.parents);
+        SER_READ(obj, obj.cached_root = nullopt);
         obj.wfcheck();
     }
 
@@ -133,6 +150,8 @@ private:
 
     // Collapsed "left" subtrees ordered toward the root of the tree.
     std::vector<Optional<Hash>> parents;
+    // Root of the full depth tree, not part of the serialized frontier.
+    mutable Optional<Hash> cached_root;
     MerklePath path(std::deque<Hash> filler_hashes = std::deque<Hash>()) const;
     Hash root(size_t depth, std::deque<Hash> filler_hashes = std::deque<Hash>()) const;
     bool is_complete(size_t depth = Depth) const;
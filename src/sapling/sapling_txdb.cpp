@@ -18,6 +18,10 @@ bool CCoinsViewDB::GetSaplingAnchorAt(const uint256 &rt, SaplingMerkleTree &tree
     }
 
     bool read = db.Read(std::make_pair(DB_SAPLING_ANCHOR, rt), tree);
+    if (read) {
+        // Anchors are keyed by the tree root, no need to hash it again
+        tree.set_cached_root(rt);
+    }
 
     return read;
 }
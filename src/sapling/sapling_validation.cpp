@@ -160,7 +160,10 @@ bool ContextualCheckTransaction(
                              REJECT_INVALID, "error-computing-signature-hash");
         }
 
-        // Sapling verification process
+        // Sapling verification process. The parameters are loaded in the background at startup.
+        if (!WaitForZKSNARKS()) {
+            return state.Error("sapling-params-not-loaded");
+        }
         auto ctx = librustzcash_sapling_verification_ctx_init();
 
         for (const SpendDescription &spend : tx.sapData->vShieldedSpend) {
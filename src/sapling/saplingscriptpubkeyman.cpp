@@ -8,6 +8,9 @@
 #include "chain.h" // for CBlockIndex
 #include "validation.h" // for ReadBlockFromDisk()
 
+// The memo of the notes sent without one, not cached in SaplingNoteData
+static const std::array<unsigned char, ZC_MEMO_SIZE> EMPTY_MEMO = {{0xF6}};
+
 void SaplingScriptPubKeyMan::AddToSaplingSpends(const uint256& nullifier, const uint256& wtxid)
 {
     AssertLockHeld(wallet->cs_wallet);
@@ -108,6 +111,17 @@ void SaplingScriptPubKeyMan::UpdateNullifierNoteMapWithTx(const CWalletTx& wtx)
     }
 }
 
+void SaplingScriptPubKeyMan::UpdateAddressNoteMapWithTx(const CWalletTx& wtx)
+{
+    LOCK(wallet->cs_wallet);
+    for (const mapSaplingNoteData_t::value_type& item : wtx.mapSaplingNoteData) {
+        const SaplingNoteData& nd = item.second;
+        if (nd.IsMyNote() && nd.address) {
+            mapSaplingNotesByAddress[*nd.address].insert(item.first);
+        }
+    }
+}
+
 template<typename NoteDataMap>
 void CopyPreviousWitnesses(NoteDataMap& noteDataMap, int indexHeight, int64_t nWitnessCacheSize)
 {
@@ -390,6 +404,9 @@ std::pair<mapSaplingNoteData_t, SaplingIncomingViewingKeyMap> SaplingScriptPubKe
             if (memo[0] < 0xF6) {
                 nd.memo = memo;
             }
+            if (nd.memo || memo == EMPTY_MEMO) {
+                nd.rcm = result->rcm;
+            }
             noteData.insert(std::make_pair(op, nd));
             break;
         }
@@ -424,10 +441,11 @@ std::vector<libzcash::SaplingPaymentAddress> SaplingScriptPubKeyMan::FindMySapli
 void SaplingScriptPubKeyMan::GetNotes(const std::vector<SaplingOutPoint>& saplingOutpoints,
                                       std::vector<SaplingNoteEntry>& saplingEntriesRet) const
 {
+    LOCK(wallet->cs_wallet);
     for (const auto& outpoint : saplingOutpoints) {
         const auto* wtx = wallet->GetWalletTx(outpoint.hash);
         if (!wtx) throw std::runtime_error("No transaction available for hash " + outpoint.hash.GetHex());
-        const int depth = WITH_LOCK(wallet->cs_wallet, return wtx->GetDepthInMainChain(); );
+        const int depth = wtx->GetDepthInMainChain();
         const auto& it = wtx->mapSaplingNoteData.find(outpoint);
         if (it != wtx->mapSaplingNoteData.end()) {
             const SaplingOutPoint& op = it->first;
@@ -436,18 +454,36 @@ void SaplingScriptPubKeyMan::GetNotes(const std::vector<SaplingOutPoint>& saplin
             // skip sent notes
             if (!nd.IsMyNote()) continue;
 
-            // recover plaintext and address
-            auto optNotePtAndAddress = wtx->DecryptSaplingNote(op);
-            assert(static_cast<bool>(optNotePtAndAddress));
+            saplingEntriesRet.push_back(GetNoteEntry(*wtx, op, nd, depth));
+        }
+    }
+}
 
-            const libzcash::SaplingIncomingViewingKey& ivk = *(nd.ivk);
-            const libzcash::SaplingNotePlaintext& notePt = optNotePtAndAddress->first;
-            const libzcash::SaplingPaymentAddress& pa = optNotePtAndAddress->second;
-            auto note = notePt.note(ivk).get();
+SaplingNoteEntry SaplingScriptPubKeyMan::GetNoteEntry(const CWalletTx& wtx,
+                                                      const SaplingOutPoint& op,
+                                                      const SaplingNoteData& nd,
+                                                      int depth) const
+{
+    if (nd.rcm && nd.address && nd.amount) {
+        const libzcash::SaplingPaymentAddress& pa = *nd.address;
+        libzcash::SaplingNote note(pa.d, pa.pk_d, *nd.amount, *nd.rcm);
+        return SaplingNoteEntry(op, pa, note, nd.memo ? *nd.memo : EMPTY_MEMO, depth);
+    }
 
-            saplingEntriesRet.emplace_back(op, pa, note, notePt.memo(), depth);
-        }
+    // recover plaintext and address
+    auto optNotePtAndAddress = wtx.DecryptSaplingNote(op);
+    assert(static_cast<bool>(optNotePtAndAddress));
+
+    const libzcash::SaplingIncomingViewingKey& ivk = *(nd.ivk);
+    const libzcash::SaplingNotePlaintext& notePt = optNotePtAndAddress->first;
+    const libzcash::SaplingPaymentAddress& pa = optNotePtAndAddress->second;
+    auto note = notePt.note(ivk).get();
+
+    // cache it, unless the memo is one that the note data does not keep
+    if (nd.address && nd.amount && (nd.memo || notePt.memo() == EMPTY_MEMO)) {
+        nd.rcm = notePt.rcm;
     }
+    return SaplingNoteEntry(op, pa, note, notePt.memo(), depth);
 }
 
 /**
@@ -486,58 +522,62 @@ void SaplingScriptPubKeyMan::GetFilteredNotes(
 {
     LOCK(wallet->cs_wallet);
 
-    for (auto& p : wallet->mapWallet) {
-        const CWalletTx& wtx = p.second;
-
-        // Filter coinbase/coinstakes transactions that don't have Sapling outputs
-        if ((wtx.IsCoinBase() || wtx.IsCoinStake()) && wtx.mapSaplingNoteData.empty()) {
-            continue;
+    // Collect the notes of the requested addresses, in outpoint order
+    std::vector<SaplingOutPoint> vNotes;
+    if (filterAddresses.empty()) {
+        for (const auto& it : mapSaplingNotesByAddress) {
+            vNotes.insert(vNotes.end(), it.second.begin(), it.second.end());
+        }
+    } else {
+        for (const auto& addr : filterAddresses) {
+            auto saplingAddr = boost::get<libzcash::SaplingPaymentAddress>(&addr);
+            if (saplingAddr == nullptr) continue;
+            auto it = mapSaplingNotesByAddress.find(*saplingAddr);
+            if (it != mapSaplingNotesByAddress.end()) {
+                vNotes.insert(vNotes.end(), it->second.begin(), it->second.end());
+            }
         }
+    }
+    std::sort(vNotes.begin(), vNotes.end());
+    vNotes.erase(std::unique(vNotes.begin(), vNotes.end()), vNotes.end());
 
+    const CWalletTx* wtx = nullptr;
+    int depth = 0;
+    bool fSkipTx = true;
+    for (const SaplingOutPoint& op : vNotes) {
         // Filter the transactions before checking for notes
-        const int depth = wtx.GetDepthInMainChain();
-        if (!IsFinalTx(wtx.tx, wallet->GetLastBlockHeight() + 1, GetAdjustedTime()) ||
-            depth < minDepth || depth > maxDepth) {
-            continue;
+        if (!wtx || wtx->GetHash() != op.hash) {
+            wtx = wallet->GetWalletTx(op.hash);
+            if (!wtx) continue;
+            depth = wtx->GetDepthInMainChain();
+            fSkipTx = !IsFinalTx(wtx->tx, wallet->GetLastBlockHeight() + 1, GetAdjustedTime()) ||
+                      depth < minDepth || depth > maxDepth;
         }
+        if (fSkipTx) continue;
 
-        for (const auto& it : wtx.mapSaplingNoteData) {
-            const SaplingOutPoint& op = it.first;
-            const SaplingNoteData& nd = it.second;
+        const auto& it = wtx->mapSaplingNoteData.find(op);
+        if (it == wtx->mapSaplingNoteData.end()) continue;
+        const SaplingNoteData& nd = it->second;
 
-            // skip sent notes
-            if (!nd.IsMyNote()) continue;
+        // skip sent notes
+        if (!nd.IsMyNote() || !nd.address) continue;
+        const libzcash::SaplingPaymentAddress& pa = *nd.address;
 
-            // recover plaintext and address
-            auto optNotePtAndAddress = wtx.DecryptSaplingNote(op);
-            assert(static_cast<bool>(optNotePtAndAddress));
-
-            const libzcash::SaplingIncomingViewingKey& ivk = *(nd.ivk);
-            const libzcash::SaplingNotePlaintext& notePt = optNotePtAndAddress->first;
-            const libzcash::SaplingPaymentAddress& pa = optNotePtAndAddress->second;
-            auto note = notePt.note(ivk).get();
-
-            // skip notes which belong to a different payment address in the wallet
-            if (!(filterAddresses.empty() || filterAddresses.count(pa))) {
-                continue;
-            }
-
-            if (ignoreSpent && nd.nullifier && IsSaplingSpent(*nd.nullifier)) {
-                continue;
-            }
+        if (ignoreSpent && nd.nullifier && IsSaplingSpent(*nd.nullifier)) {
+            continue;
+        }
 
-            // skip notes which cannot be spent
-            if (requireSpendingKey && !HaveSpendingKeyForPaymentAddress(pa)) {
-                continue;
-            }
+        // skip notes which cannot be spent
+        if (requireSpendingKey && !HaveSpendingKeyForPaymentAddress(pa)) {
+            continue;
+        }
 
-            // skip locked notes. todo: Implement locked notes..
-            //if (ignoreLocked && IsLockedNote(op)) {
-            //    continue;
-            //}
+        // skip locked notes. todo: Implement locked notes..
+        //if (ignoreLocked && IsLockedNote(op)) {
+        //    continue;
+        //}
 
-            saplingEntries.emplace_back(op, pa, note, notePt.memo(), depth);
-        }
+        saplingEntries.push_back(GetNoteEntry(*wtx, op, nd, depth));
     }
 }
 
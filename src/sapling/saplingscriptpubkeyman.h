@@ -68,6 +68,14 @@ public:
       */
      Optional<std::array<unsigned char, ZC_MEMO_SIZE>> memo{nullopt};
 
+    /**
+     * Cached note commitment randomness. Along with the address, amount and memo
+     * above, it is all that is needed to rebuild the note without decrypting it again.
+     * Kept in memory only: set when the note is found, or the first time it is
+     * decrypted after the wallet is loaded.
+     */
+    mutable Optional<uint256> rcm{nullopt};
+
     /**
      * Block height corresponding to the most current witness.
      *
@@ -182,6 +190,11 @@ public:
      */
     void UpdateSaplingNullifierNoteMapWithTx(CWalletTx& wtx);
 
+    /**
+     * Update mapSaplingNotesByAddress with the own notes of this tx.
+     */
+    void UpdateAddressNoteMapWithTx(const CWalletTx& wtx);
+
     /**
      * Iterate over transactions in a block and update the cached Sapling nullifiers
      * for transactions which belong to the wallet.
@@ -407,6 +420,18 @@ public:
 private:
     /* Parent wallet */
     CWallet* wallet{nullptr};
+
+    /**
+     * Own notes by payment address, so that the note queries only look at the
+     * notes of the addresses they ask for. Entries are only added: a note is
+     * checked against mapWallet when read, and its spent state is taken from
+     * mapTxSaplingNullifiers (the spending tx can be conflicted or abandoned).
+     */
+    std::map<libzcash::SaplingPaymentAddress, std::set<SaplingOutPoint>> mapSaplingNotesByAddress;
+
+    //! Note entry of an own note, from the cached plaintext if it is there, decrypting it otherwise
+    SaplingNoteEntry GetNoteEntry(const CWalletTx& wtx, const SaplingOutPoint& op, const SaplingNoteData& nd, int depth) const;
+
     /* the HD chain data model (external/internal chain counters) */
     CHDChain hdChain;
     /* cached common OVK for sapling spends from t addresses */
@@ -10,8 +10,49 @@
 #include "consensus/upgrades.h"
 #include "policy/policy.h"
 #include "validation.h"
+#include "ctpl_stl.h"
+#include "util/system.h"
+#include "util/threadnames.h"
 
 #include <librustzcash.h>
+#include <mutex>
+
+/** Upper bound on the threads creating the Sapling proofs of one transaction */
+static const int MAX_SAPLING_PROVING_THREADS = 8;
+
+/** Threads helping the caller create the proofs, shared by every transaction being built */
+static ctpl::thread_pool& GetSaplingProvingPool()
+{
+    static ctpl::thread_pool provingPool(std::max(1, std::min(GetNumCores(), MAX_SAPLING_PROVING_THREADS) - 1));
+    static std::once_flag renameOnce;
+    std::call_once(renameOnce, [] { RenameThreadPool(provingPool, "bcz-saplprove"); });
+    return provingPool;
+}
+
+namespace {
+/** The Sapling proving contexts of one transaction, freed however the build ends */
+class SaplingProvingContexts
+{
+public:
+    explicit SaplingProvingContexts(size_t nContexts)
+    {
+        for (size_t i = 0; i < nContexts; i++) {
+            vCtx.push_back(librustzcash_sapling_proving_ctx_init());
+        }
+    }
+    ~SaplingProvingContexts()
+    {
+        for (void* ctx : vCtx) librustzcash_sapling_proving_ctx_free(ctx);
+    }
+    SaplingProvingContexts(const SaplingProvingContexts&) = delete;
+    SaplingProvingContexts& operator=(const SaplingProvingContexts&) = delete;
+
+    void* operator[](size_t i) const { return vCtx[i]; }
+
+private:
+    std::vector<void*> vCtx;
+};
+} // anon namespace
 
 SpendDescriptionInfo::SpendDescriptionInfo(const libzcash::SaplingExpandedSpendingKey& _expsk,
                                            const libzcash::SaplingNote& _note,
@@ -25,6 +66,39 @@ SpendDescriptionInfo::SpendDescriptionInfo(const libzcash::SaplingExpandedSpendi
     librustzcash_sapling_generate_r(alpha.begin());
 }
 
+Optional<SpendDescription> SpendDescriptionInfo::Build(void* ctx)
+{
+    auto nf = this->note.nullifier(this->expsk.full_viewing_key(), this->witness.position());
+    if (!nf) {
+        return nullopt;
+    }
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << this->witness.path();
+    std::vector<unsigned char> witnessBytes(ss.begin(), ss.end());
+
+    SpendDescription sdesc;
+    if (!librustzcash_sapling_spend_proof(
+            ctx,
+            this->expsk.full_viewing_key().ak.begin(),
+            this->expsk.nsk.begin(),
+            this->note.d.data(),
+            this->note.r.begin(),
+            this->alpha.begin(),
+            this->note.value(),
+            this->anchor.begin(),
+            witnessBytes.data(),
+            sdesc.cv.begin(),
+            sdesc.rk.begin(),
+            sdesc.zkproof.data())) {
+        return nullopt;
+    }
+
+    sdesc.anchor = this->anchor;
+    sdesc.nullifier = *nf;
+    return sdesc;
+}
+
 Optional<OutputDescription> OutputDescriptionInfo::Build(void* ctx) {
     auto cmu = this->note.cmu();
     if (!cmu) {
@@ -231,6 +305,40 @@ void TransactionBuilder::SendChangeTo(const CTxDestination& changeAddr)
     saplingChangeAddr = nullopt;
 }
 
+// Check the proofs and signatures of a freshly built transaction, as the
+// mempool will, so that a bad proof is reported here instead of on commit.
+static bool CheckShieldedProofs(const CMutableTransaction& mtx, const uint256& dataToBeSigned)
+{
+    auto ctx = librustzcash_sapling_verification_ctx_init();
+    bool fValid = true;
+    for (const SpendDescription& spend : mtx.sapData->vShieldedSpend) {
+        fValid = fValid && librustzcash_sapling_check_spend(
+                ctx,
+                spend.cv.begin(),
+                spend.anchor.begin(),
+                spend.nullifier.begin(),
+                spend.rk.begin(),
+                spend.zkproof.begin(),
+                spend.spendAuthSig.begin(),
+                dataToBeSigned.begin());
+    }
+    for (const OutputDescription& output : mtx.sapData->vShieldedOutput) {
+        fValid = fValid && librustzcash_sapling_check_output(
+                ctx,
+                output.cv.begin(),
+                output.cmu.begin(),
+                output.ephemeralKey.begin(),
+                output.zkproof.begin());
+    }
+    fValid = fValid && librustzcash_sapling_final_check(
+            ctx,
+            mtx.sapData->valueBalance,
+            mtx.sapData->bindingSig.begin(),
+            dataToBeSigned.begin());
+    librustzcash_sapling_verification_ctx_free(ctx);
+    return fValid;
+}
+
 TransactionBuilderResult TransactionBuilder::ProveAndSign()
 {
     //
@@ -238,60 +346,80 @@ TransactionBuilderResult TransactionBuilder::ProveAndSign()
     //
     if (!spends.empty() || !outputs.empty()) {
 
-        auto ctx = librustzcash_sapling_proving_ctx_init();
+        // The parameters are loaded in the background at startup
+        if (!WaitForZKSNARKS()) {
+            return TransactionBuilderResult("Sapling parameters not loaded");
+        }
 
-        // Create Sapling OutputDescriptions
-        for (auto output : outputs) {
-            // Check this out here as well to provide better logging.
+        // Check this out here as well to provide better logging.
+        for (const auto& output : outputs) {
             if (!output.note.cmu()) {
-                librustzcash_sapling_proving_ctx_free(ctx);
                 return TransactionBuilderResult("Output is invalid");
             }
+        }
+        for (const auto& spend : spends) {
+            if (!spend.note.cmu() || !spend.note.nullifier(spend.expsk.full_viewing_key(), spend.witness.position())) {
+                return TransactionBuilderResult("Spend is invalid");
+            }
+        }
 
-            auto odesc = output.Build(ctx);
+        // Each proof takes about a second. They are independent, except for the
+        // value commitment sums behind the binding signature, so every thread
+        // proves with its own context and the contexts are merged afterwards.
+        // Jobs [0, spends.size()) are the spends, the rest are the outputs.
+        const size_t nJobs = spends.size() + outputs.size();
+        const size_t nThreads = std::max<size_t>(1, std::min<size_t>(nJobs, std::min(GetNumCores(), MAX_SAPLING_PROVING_THREADS)));
+        const SaplingProvingContexts vCtx(nThreads);
+
+        std::vector<Optional<SpendDescription>> vSpendDescs(spends.size());
+        std::vector<Optional<OutputDescription>> vOutputDescs(outputs.size());
+        auto proveJobs = [&](size_t nThread) {
+            // Interleaved, so that the slower spend proofs are spread evenly
+            for (size_t nJob = nThread; nJob < nJobs; nJob += nThreads) {
+                if (nJob < spends.size()) {
+                    vSpendDescs[nJob] = spends[nJob].Build(vCtx[nThread]);
+                } else {
+                    vOutputDescs[nJob - spends.size()] = outputs[nJob - spends.size()].Build(vCtx[nThread]);
+                }
+            }
+        };
+        if (nThreads > 1) {
+            ctpl::thread_pool& provingPool = GetSaplingProvingPool();
+            std::vector<std::future<void>> vFutures;
+            for (size_t i = 1; i < nThreads; i++) {
+                vFutures.emplace_back(provingPool.push([&proveJobs, i](int) { proveJobs(i); }));
+            }
+            // The jobs use this frame: let all of them finish before any error unwinds it
+            try {
+                proveJobs(0);
+            } catch (...) {
+                for (auto& f : vFutures) f.wait();
+                throw;
+            }
+            for (auto& f : vFutures) f.wait();
+            for (auto& f : vFutures) f.get();
+        } else {
+            proveJobs(0);
+        }
+
+        // Create Sapling OutputDescriptions
+        for (const auto& odesc : vOutputDescs) {
             if (!odesc) {
-                librustzcash_sapling_proving_ctx_free(ctx);
                 return TransactionBuilderResult("Failed to create output description");
             }
-
-            mtx.sapData->vShieldedOutput.push_back(odesc.get());
+            mtx.sapData->vShieldedOutput.push_back(*odesc);
         }
 
         // Create Sapling SpendDescriptions
-        for (auto spend : spends) {
-            auto cm = spend.note.cmu();
-            auto nf = spend.note.nullifier(
-                    spend.expsk.full_viewing_key(), spend.witness.position());
-            if (!cm || !nf) {
-                librustzcash_sapling_proving_ctx_free(ctx);
-                return TransactionBuilderResult("Spend is invalid");
-            }
-
-            CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-            ss << spend.witness.path();
-            std::vector<unsigned char> witness(ss.begin(), ss.end());
-
-            SpendDescription sdesc;
-            if (!librustzcash_sapling_spend_proof(
-                    ctx,
-                    spend.expsk.full_viewing_key().ak.begin(),
-                    spend.expsk.nsk.begin(),
-                    spend.note.d.data(),
-                    spend.note.r.begin(),
-                    spend.alpha.begin(),
-                    spend.note.value(),
-                    spend.anchor.begin(),
-                    witness.data(),
-                    sdesc.cv.begin(),
-                    sdesc.rk.begin(),
-                    sdesc.zkproof.data())) {
-                librustzcash_sapling_proving_ctx_free(ctx);
+        for (const auto& sdesc : vSpendDescs) {
+            if (!sdesc) {
                 return TransactionBuilderResult("Spend proof failed");
             }
+            mtx.sapData->vShieldedSpend.push_back(*sdesc);
+        }
 
-            sdesc.anchor = spend.anchor;
-            sdesc.nullifier = *nf;
-            mtx.sapData->vShieldedSpend.push_back(sdesc);
+        for (size_t i = 1; i < nThreads; i++) {
+            librustzcash_sapling_proving_ctx_merge(vCtx[0], vCtx[i]);
         }
 
         //
@@ -304,7 +432,6 @@ TransactionBuilderResult TransactionBuilder::ProveAndSign()
         try {
             dataToBeSigned = SignatureHash(scriptCode, mtx, NOT_AN_INPUT, SIGHASH_ALL, 0, SIGVERSION_SAPLING);
         } catch (const std::logic_error& ex) {
-            librustzcash_sapling_proving_ctx_free(ctx);
             return TransactionBuilderResult("Could not construct signature hash: " + std::string(ex.what()));
         }
 
@@ -317,13 +444,18 @@ TransactionBuilderResult TransactionBuilder::ProveAndSign()
                     mtx.sapData->vShieldedSpend[i].spendAuthSig.data());
         }
 
-        librustzcash_sapling_binding_sig(
-                ctx,
+        bool fBindingSig = librustzcash_sapling_binding_sig(
+                vCtx[0],
                 mtx.sapData->valueBalance,
                 dataToBeSigned.begin(),
                 mtx.sapData->bindingSig.data());
 
-        librustzcash_sapling_proving_ctx_free(ctx);
+        if (!fBindingSig) {
+            return TransactionBuilderResult("Failed to create binding signature");
+        }
+        if (!CheckShieldedProofs(mtx, dataToBeSigned)) {
+            return TransactionBuilderResult("Sapling proof verification failed");
+        }
     }
 
     // Transparent signatures
@@ -31,6 +31,9 @@ struct SpendDescriptionInfo {
         const libzcash::SaplingNote& _note,
         const uint256& _anchor,
         const SaplingWitness& _witness);
+
+    // Create the spend proof. The spendAuthSig is left empty.
+    Optional<SpendDescription> Build(void* ctx);
 };
 
 struct OutputDescriptionInfo {
@@ -12,6 +12,7 @@
 #include "crypto/sha256.h"
 #include "pubkey.h"
 #include "script/script.h"
+#include "streams.h"
 
 
 typedef std::vector<unsigned char> valtype;
@@ -1072,26 +1073,34 @@ public:
             ::Serialize(s, txTo.vout[nOutput]);
     }
 
-    /** Serialize txTo */
+    /** Serialize nVersion, nType and the number of inputs */
     template<typename S>
-    void Serialize(S &s) const {
-        // Serialize nVersion
+    void SerializeHeader(S &s) const {
         ::Serialize(s, txTo.nVersion);
-        // Serialize nType
         ::Serialize(s, txTo.nType);
-        // Serialize vin
-        unsigned int nInputs = fAnyoneCanPay ? 1 : txTo.vin.size();
-        ::WriteCompactSize(s, nInputs);
-        for (unsigned int nInput = 0; nInput < nInputs; nInput++)
-             SerializeInput(s, nInput);
-        // Serialize vout
+        ::WriteCompactSize(s, fAnyoneCanPay ? 1 : txTo.vin.size());
+    }
+
+    /** Serialize vout and nLockTime */
+    template<typename S>
+    void SerializeOutputs(S &s) const {
         unsigned int nOutputs = fHashNone ? 0 : (fHashSingle ? nIn+1 : txTo.vout.size());
         ::WriteCompactSize(s, nOutputs);
         for (unsigned int nOutput = 0; nOutput < nOutputs; nOutput++)
              SerializeOutput(s, nOutput);
-        // Serialize nLockTime
         ::Serialize(s, txTo.nLockTime);
     }
+
+    /** Serialize txTo */
+    template<typename S>
+    void Serialize(S &s) const {
+        SerializeHeader(s);
+        // Serialize vin
+        unsigned int nInputs = fAnyoneCanPay ? 1 : txTo.vin.size();
+        for (unsigned int nInput = 0; nInput < nInputs; nInput++)
+             SerializeInput(s, nInput);
+        SerializeOutputs(s);
+    }
 };
 
 const unsigned char BCZ_PREVOUTS_HASH_PERSONALIZATION[crypto_generichash_blake2b_PERSONALBYTES] =
@@ -1155,6 +1164,9 @@ uint256 GetShieldedOutputsHash(const CTransaction& txTo) {
     return ss.GetHash();
 }
 
+//! Minimum number of inputs for PrecomputedTransactionData to cache the legacy signature hash
+const unsigned int LEGACY_SIGHASH_CACHE_MIN_INPUTS = 6;
+
 } // anon namespace
 
 PrecomputedTransactionData::PrecomputedTransactionData(const CTransaction& txTo)
@@ -1166,6 +1178,25 @@ PrecomputedTransactionData::PrecomputedTransactionData(const CTransaction& txTo)
         hashShieldedSpends = GetShieldedSpendsHash(txTo);
         hashShieldedOutputs = GetShieldedOutputsHash(txTo);
     }
+
+    // Below a few inputs, building the prefixes costs more than it saves
+    if (!txTo.isSaplingVersion() && txTo.vin.size() >= LEGACY_SIGHASH_CACHE_MIN_INPUTS) {
+        // With nIn out of range every input is blanked
+        const CTransactionSignatureSerializer txBlanked(txTo, CScript(), NOT_AN_INPUT, SIGHASH_ALL);
+        CVectorWriter tail(SER_GETHASH, 0, vchLegacyTail, 0);
+        CHashWriter prefix(SER_GETHASH, 0);
+        txBlanked.SerializeHeader(prefix);
+        vLegacyPrefix.reserve(txTo.vin.size());
+        vLegacyTailPos.reserve(txTo.vin.size());
+        for (unsigned int n = 0; n < txTo.vin.size(); n++) {
+            vLegacyPrefix.push_back(prefix);
+            const size_t nPos = vchLegacyTail.size();
+            txBlanked.SerializeInput(tail, n);
+            prefix.write((const char*)vchLegacyTail.data() + nPos, vchLegacyTail.size() - nPos);
+            vLegacyTailPos.push_back(vchLegacyTail.size());
+        }
+        txBlanked.SerializeOutputs(tail);
+    }
 }
 
 uint256 SignatureHash(const CScript& scriptCode, const CTransaction& txTo, unsigned int nIn, int nHashType, const CAmount& amount, SigVersion sigversion, const PrecomputedTransactionData* cache)
@@ -1276,6 +1307,17 @@ uint256 SignatureHash(const CScript& scriptCode, const CTransaction& txTo, unsig
     // Wrapper to serialize only the necessary parts of the transaction being signed
     CTransactionSignatureSerializer txTmp(txTo, scriptCode, nIn, nHashType);
 
+    if (cache && !cache->vLegacyPrefix.empty() && nIn != NOT_AN_INPUT && (nHashType & (0x1f | SIGHASH_ANYONECANPAY)) == SIGHASH_ALL) {
+        // Resume from the hash of the inputs before nIn, then append the input and the precomputed rest
+        assert(cache->vLegacyPrefix.size() == txTo.vin.size());
+        CHashWriter ss(cache->vLegacyPrefix[nIn]);
+        txTmp.SerializeInput(ss, nIn);
+        const size_t nTailPos = cache->vLegacyTailPos[nIn];
+        ss.write((const char*)cache->vchLegacyTail.data() + nTailPos, cache->vchLegacyTail.size() - nTailPos);
+        ss << nHashType;
+        return ss.GetHash();
+    }
+
     // Serialize and hash
     CHashWriter ss(SER_GETHASH, 0);
     ss << txTmp << nHashType;
@@ -7,6 +7,7 @@
 #ifndef BITCOIN_SCRIPT_INTERPRETER_H
 #define BITCOIN_SCRIPT_INTERPRETER_H
 
+#include "hash.h"
 #include "primitives/transaction.h"
 #include "script_error.h"
 #include "uint256.h"
@@ -89,6 +90,19 @@ struct PrecomputedTransactionData
 {
     uint256 hashPrevouts, hashSequence, hashOutputs, hashShieldedSpends, hashShieldedOutputs;
 
+    /**
+     * Legacy (non-Sapling) SIGHASH_ALL signature hash of a multi-input transaction.
+     * The hashed serialization of input i is <part before i><input i><part after i>,
+     * where only input i differs between inputs (it carries the scriptCode, the others
+     * an empty script). So keep the hash state after each part before, and the bytes
+     * of each part after, instead of serializing and hashing the whole transaction
+     * again for every input. Neither depends on the scriptSigs, so this stays valid
+     * while the inputs are being signed.
+     */
+    std::vector<CHashWriter> vLegacyPrefix;
+    std::vector<unsigned char> vchLegacyTail;
+    std::vector<size_t> vLegacyTailPos;
+
     PrecomputedTransactionData(const CTransaction& tx);
 };
 
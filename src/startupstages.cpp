@@ -0,0 +1,143 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "startupstages.h"
+
+#include "logging.h"
+#include "util/system.h"
+#include "util/threadnames.h"
+#include "utiltime.h"
+
+#include <univalue.h>
+
+CStartupStages g_startupStages;
+
+UniValue StartupStage::ToJSON() const
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("name", name);
+    ret.pushKV("background", fBackground);
+    ret.pushKV("start_ms", nStart);
+    if (nDuration >= 0) {
+        ret.pushKV("duration_ms", nDuration);
+        ret.pushKV("success", fSuccess);
+    } else {
+        ret.pushKV("running", true);
+    }
+    return ret;
+}
+
+CStartupStages::CStartupStages() : nStartTime(GetTimeMillis()) {}
+
+size_t CStartupStages::BeginStage(const std::string& name, bool fBackground)
+{
+    LOCK(cs);
+    StartupStage stage;
+    stage.name = name;
+    stage.fBackground = fBackground;
+    stage.nStart = GetTimeMillis() - nStartTime;
+    vStages.push_back(stage);
+    return vStages.size() - 1;
+}
+
+size_t CStartupStages::Begin(const std::string& name)
+{
+    return BeginStage(name, false);
+}
+
+void CStartupStages::End(size_t nId, bool fSuccess)
+{
+    LOCK(cs);
+    StartupStage& stage = vStages.at(nId);
+    stage.nDuration = GetTimeMillis() - nStartTime - stage.nStart;
+    stage.fSuccess = fSuccess;
+    LogPrintf("%s: %s %s in %dms\n", __func__, stage.name, fSuccess ? "done" : "failed", stage.nDuration);
+}
+
+void CStartupStages::Launch(const std::string& name, std::function<bool()> fn)
+{
+    const size_t nId = BeginStage(name, true);
+    auto run = [this, name, fn, nId]() {
+        bool fSuccess = false;
+        try {
+            fSuccess = fn();
+        } catch (const std::exception& e) {
+            PrintExceptionContinue(&e, name.c_str());
+        } catch (...) {
+            PrintExceptionContinue(nullptr, name.c_str());
+        }
+        End(nId, fSuccess);
+        return fSuccess;
+    };
+
+    std::future<bool> result;
+    try {
+        result = std::async(std::launch::async, [name, run]() {
+            util::ThreadRename("bcz-" + name);
+            return run();
+        });
+    } catch (const std::system_error& e) {
+        // No thread to spare, run the stage in place
+        LogPrintf("%s: unable to start a thread for %s (%s), running it now\n", __func__, name, e.what());
+        std::promise<bool> done;
+        done.set_value(run());
+        result = done.get_future();
+    }
+
+    LOCK(cs);
+    mapLaunched[name] = std::move(result);
+}
+
+bool CStartupStages::Wait(const std::string& name)
+{
+    std::future<bool> result;
+    {
+        LOCK(cs);
+        auto it = mapLaunched.find(name);
+        if (it == mapLaunched.end()) return false;
+        result = std::move(it->second);
+        mapLaunched.erase(it);
+    }
+    return result.get();
+}
+
+void CStartupStages::WaitAll()
+{
+    std::map<std::string, std::future<bool>> mapWait;
+    {
+        LOCK(cs);
+        mapWait.swap(mapLaunched);
+    }
+    for (auto& it : mapWait) {
+        it.second.wait();
+    }
+}
+
+void CStartupStages::Finish()
+{
+    LOCK(cs);
+    nReadyTime = GetTimeMillis() - nStartTime;
+    LogPrintf("Startup stages (start, duration):\n");
+    for (const StartupStage& stage : vStages) {
+        if (stage.nDuration < 0) {
+            LogPrintf(" %-16s %8dms  running%s\n", stage.name, stage.nStart, stage.fBackground ? " (background)" : "");
+        } else {
+            LogPrintf(" %-16s %8dms %8dms%s%s\n", stage.name, stage.nStart, stage.nDuration,
+                      stage.fBackground ? " (background)" : "", stage.fSuccess ? "" : " failed");
+        }
+    }
+    LogPrintf("Node ready in %dms\n", nReadyTime);
+}
+
+std::vector<StartupStage> CStartupStages::GetStages() const
+{
+    LOCK(cs);
+    return vStages;
+}
+
+int64_t CStartupStages::GetReadyTime() const
+{
+    LOCK(cs);
+    return nReadyTime;
+}
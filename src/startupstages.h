@@ -0,0 +1,77 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_STARTUPSTAGES_H
+#define BCZ_STARTUPSTAGES_H
+
+#include "sync.h"
+
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+class UniValue;
+
+/** One stage of the node startup, times in milliseconds */
+struct StartupStage
+{
+    std::string name;
+    //! Run on its own thread, alongside the stages that follow it
+    bool fBackground{false};
+    //! Offset of the stage start from the process start
+    int64_t nStart{0};
+    //! -1 while the stage is running
+    int64_t nDuration{-1};
+    bool fSuccess{false};
+
+    UniValue ToJSON() const;
+};
+
+/**
+ * Times the stages of AppInitMain. A stage that does not depend on the ones
+ * before it is launched on its own thread and waited for by the first stage
+ * that needs its result, so that independent disk reads (block index, wallet
+ * databases, flat-file caches, Sapling parameters) overlap.
+ */
+class CStartupStages
+{
+public:
+    CStartupStages();
+
+    /** Start timing a stage run by the calling thread, returns the id to pass to End */
+    size_t Begin(const std::string& name);
+    void End(size_t nId, bool fSuccess = true);
+
+    /** Run fn as a stage on its own thread */
+    void Launch(const std::string& name, std::function<bool()> fn);
+
+    /** Wait for the launched stage name, returns its result (false if it was not launched) */
+    bool Wait(const std::string& name);
+
+    /** Wait for all the launched stages, before tearing down what they load */
+    void WaitAll();
+
+    /** The node is ready: log the stage timings */
+    void Finish();
+
+    std::vector<StartupStage> GetStages() const;
+    //! Time from the process start until Finish, -1 while starting
+    int64_t GetReadyTime() const;
+
+private:
+    size_t BeginStage(const std::string& name, bool fBackground);
+
+    const int64_t nStartTime;
+
+    mutable Mutex cs;
+    std::vector<StartupStage> vStages GUARDED_BY(cs);
+    std::map<std::string, std::future<bool>> mapLaunched GUARDED_BY(cs);
+    int64_t nReadyTime GUARDED_BY(cs){-1};
+};
+
+extern CStartupStages g_startupStages;
+
+#endif // BCZ_STARTUPSTAGES_H
@@ -8,6 +8,7 @@
 #define BITCOIN_STREAMS_H
 
 #include "serialize.h"
+#include "span.h"
 #include "support/allocators/zeroafterfree.h"
 
 #include <algorithm>
@@ -66,6 +67,54 @@ public:
     void ignore(size_t size) { return stream->ignore(size); }
 };
 
+/** Minimal stream for deserializing in place from a buffer owned by someone else,
+ * without copying it into a CDataStream first.
+ */
+class SpanReader
+{
+private:
+    const int nType;
+    const int nVersion;
+    Span<const unsigned char> data;
+
+public:
+    SpanReader(int nTypeIn, int nVersionIn, Span<const unsigned char> dataIn) : nType(nTypeIn), nVersion(nVersionIn), data(dataIn) {}
+
+    template<typename T>
+    SpanReader& operator>>(T&& obj)
+    {
+        // Unserialize from this stream
+        ::Unserialize(*this, obj);
+        return (*this);
+    }
+
+    int GetVersion() const { return nVersion; }
+    int GetType() const { return nType; }
+
+    size_t size() const { return data.size(); }
+    bool empty() const { return data.size() == 0; }
+
+    void read(char* dst, size_t n)
+    {
+        if (n == 0) {
+            return;
+        }
+        if (n > data.size()) {
+            throw std::ios_base::failure("SpanReader::read(): end of data");
+        }
+        memcpy(dst, data.data(), n);
+        data = data.subspan(n);
+    }
+
+    void ignore(size_t n)
+    {
+        if (n > data.size()) {
+            throw std::ios_base::failure("SpanReader::ignore(): end of data");
+        }
+        data = data.subspan(n);
+    }
+};
+
 /** Double ended buffer combining vector and stream-like interfaces.
  *
  * >> and << read and write unformatted data using the above serialization templates.
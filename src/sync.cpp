@@ -9,11 +9,14 @@
 #include "utilstrencodings.h"
 #include "util/threadnames.h"
 
+#include <algorithm>
+#include <atomic>
 #include <stdio.h>
 #include <system_error>
 #include <map>
 #include <memory>
 #include <set>
+#include <tuple>
 
 #ifdef DEBUG_LOCKCONTENTION
 #if !defined(HAVE_THREAD_LOCAL)
@@ -26,6 +29,161 @@ void PrintLockContention(const char* pszName, const char* pszFile, int nLine)
 }
 #endif /* DEBUG_LOCKCONTENTION */
 
+//
+// Lock profiler. Sites live in a fixed open addressing table, claimed with a
+// compare-and-swap of their key, so recording never takes a lock or allocates.
+//
+
+static const size_t LOCK_PROFILE_SITES = 1024; // power of two
+
+struct LockSiteStats {
+    std::atomic<uint64_t> nKey{0};
+    std::atomic<bool> fReady{false};
+    const char* pszMutexName{nullptr};
+    const char* pszFile{nullptr};
+    int nLine{0};
+    std::atomic<uint64_t> nAcquired{0};
+    std::atomic<uint64_t> nContended{0};
+    std::atomic<uint64_t> nWaitNanos{0};
+    std::atomic<uint64_t> nHoldNanos{0};
+    std::atomic<uint64_t> nMaxWaitNanos{0};
+    std::atomic<uint64_t> nMaxHoldNanos{0};
+    std::atomic<uint64_t> vWaitBuckets[LOCK_PROFILE_BUCKETS] = {};
+    std::atomic<uint64_t> vHoldBuckets[LOCK_PROFILE_BUCKETS] = {};
+};
+
+static LockSiteStats g_lock_sites[LOCK_PROFILE_SITES];
+static std::atomic<uint64_t> g_lock_sites_dropped{0};
+static std::atomic<int64_t> g_lock_hold_warn_nanos{0};
+
+static uint64_t LockSiteKey(const char* pszMutexName, const char* pszFile, int nLine)
+{
+    uint64_t h = (uintptr_t)pszFile;
+    h = (h ^ (h >> 31)) * 0x9E3779B97F4A7C15ULL ^ (uintptr_t)pszMutexName;
+    h = (h ^ (h >> 31)) * 0x9E3779B97F4A7C15ULL ^ (uint64_t)nLine;
+    h = (h ^ (h >> 29)) * 0xBF58476D1CE4E5B9ULL;
+    return (h ^ (h >> 32)) | 1; // 0 marks a free slot
+}
+
+LockSiteStats* GetLockSiteStats(const char* pszMutexName, const char* pszFile, int nLine)
+{
+    const uint64_t nKey = LockSiteKey(pszMutexName, pszFile, nLine);
+    for (size_t i = 0; i < LOCK_PROFILE_SITES; i++) {
+        LockSiteStats& site = g_lock_sites[(nKey + i) & (LOCK_PROFILE_SITES - 1)];
+        uint64_t nSlotKey = site.nKey.load(std::memory_order_acquire);
+        if (nSlotKey == 0 && site.nKey.compare_exchange_strong(nSlotKey, nKey, std::memory_order_acq_rel)) {
+            site.pszMutexName = pszMutexName;
+            site.pszFile = pszFile;
+            site.nLine = nLine;
+            site.fReady.store(true, std::memory_order_release);
+            return &site;
+        }
+        if (nSlotKey == nKey) return &site;
+    }
+    g_lock_sites_dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+static size_t LockProfileBucket(int64_t nNanos)
+{
+    uint64_t nMicros = std::max<int64_t>(nNanos, 0) / 1000;
+    size_t nBucket = 0;
+    while (nMicros && nBucket < LOCK_PROFILE_BUCKETS - 1) {
+        nMicros >>= 1;
+        nBucket++;
+    }
+    return nBucket;
+}
+
+static void UpdateMax(std::atomic<uint64_t>& nMax, uint64_t nValue)
+{
+    uint64_t nCur = nMax.load(std::memory_order_relaxed);
+    while (nValue > nCur && !nMax.compare_exchange_weak(nCur, nValue, std::memory_order_relaxed)) {}
+}
+
+void RecordLockWait(LockSiteStats* site, int64_t nWaitNanos)
+{
+    site->nContended.fetch_add(1, std::memory_order_relaxed);
+    site->nWaitNanos.fetch_add(nWaitNanos, std::memory_order_relaxed);
+    site->vWaitBuckets[LockProfileBucket(nWaitNanos)].fetch_add(1, std::memory_order_relaxed);
+    UpdateMax(site->nMaxWaitNanos, nWaitNanos);
+}
+
+void RecordLockHold(LockSiteStats* site, int64_t nHoldNanos)
+{
+    site->nAcquired.fetch_add(1, std::memory_order_relaxed);
+    site->nHoldNanos.fetch_add(nHoldNanos, std::memory_order_relaxed);
+    site->vHoldBuckets[LockProfileBucket(nHoldNanos)].fetch_add(1, std::memory_order_relaxed);
+    UpdateMax(site->nMaxHoldNanos, nHoldNanos);
+    const int64_t nWarnNanos = g_lock_hold_warn_nanos.load(std::memory_order_relaxed);
+    if (nWarnNanos > 0 && nHoldNanos >= nWarnNanos && site->fReady.load(std::memory_order_acquire)) {
+        LogPrint(BCLog::LOCK, "Long lock hold: %s held for %.3f ms at %s:%d (thread %s)\n",
+                 site->pszMutexName, nHoldNanos * 1e-6, site->pszFile, site->nLine, util::ThreadGetInternalName());
+    }
+}
+
+void SetLockHoldWarnThreshold(int64_t nMillis)
+{
+    g_lock_hold_warn_nanos.store(nMillis * 1000000, std::memory_order_relaxed);
+}
+
+std::vector<LockSiteProfile> GetLockProfile()
+{
+    // Header-defined sites can be instantiated in several translation units, each
+    // with its own __FILE__ literal: merge them by name, file and line
+    std::map<std::tuple<std::string, std::string, int>, LockSiteProfile> mapSites;
+    for (const LockSiteStats& site : g_lock_sites) {
+        if (!site.fReady.load(std::memory_order_acquire)) continue;
+        LockSiteProfile& profile = mapSites[std::make_tuple(std::string(site.pszMutexName), std::string(site.pszFile), site.nLine)];
+        if (profile.vHoldBuckets.empty()) {
+            profile = LockSiteProfile{site.pszMutexName, site.pszFile, site.nLine, 0, 0, 0, 0, 0, 0,
+                                      std::vector<uint64_t>(LOCK_PROFILE_BUCKETS), std::vector<uint64_t>(LOCK_PROFILE_BUCKETS)};
+        }
+        profile.nAcquired += site.nAcquired.load(std::memory_order_relaxed);
+        profile.nContended += site.nContended.load(std::memory_order_relaxed);
+        profile.nWaitNanos += site.nWaitNanos.load(std::memory_order_relaxed);
+        profile.nHoldNanos += site.nHoldNanos.load(std::memory_order_relaxed);
+        profile.nMaxWaitNanos = std::max(profile.nMaxWaitNanos, site.nMaxWaitNanos.load(std::memory_order_relaxed));
+        profile.nMaxHoldNanos = std::max(profile.nMaxHoldNanos, site.nMaxHoldNanos.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < LOCK_PROFILE_BUCKETS; i++) {
+            profile.vWaitBuckets[i] += site.vWaitBuckets[i].load(std::memory_order_relaxed);
+            profile.vHoldBuckets[i] += site.vHoldBuckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<LockSiteProfile> vProfile;
+    vProfile.reserve(mapSites.size());
+    for (auto& it : mapSites) {
+        if (it.second.nAcquired > 0) vProfile.push_back(std::move(it.second));
+    }
+    std::sort(vProfile.begin(), vProfile.end(), [](const LockSiteProfile& a, const LockSiteProfile& b) {
+        return a.nHoldNanos > b.nHoldNanos;
+    });
+    return vProfile;
+}
+
+void ResetLockProfile()
+{
+    // Sites stay claimed, only their counters start over
+    for (LockSiteStats& site : g_lock_sites) {
+        site.nAcquired.store(0, std::memory_order_relaxed);
+        site.nContended.store(0, std::memory_order_relaxed);
+        site.nWaitNanos.store(0, std::memory_order_relaxed);
+        site.nHoldNanos.store(0, std::memory_order_relaxed);
+        site.nMaxWaitNanos.store(0, std::memory_order_relaxed);
+        site.nMaxHoldNanos.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < LOCK_PROFILE_BUCKETS; i++) {
+            site.vWaitBuckets[i].store(0, std::memory_order_relaxed);
+            site.vHoldBuckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t GetLockProfileDroppedSites()
+{
+    return g_lock_sites_dropped.load(std::memory_order_relaxed);
+}
+
 #ifdef DEBUG_LOCKORDER
 //
 // Early deadlock detection.
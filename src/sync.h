@@ -10,9 +10,12 @@
 #include "threadsafety.h"
 #include "util/macros.h"
 
+#include <chrono>
 #include <condition_variable>
+#include <string>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 
 /////////////////////////////////////////////////
@@ -74,6 +77,51 @@ void static inline DeleteLock(void* cs) {}
 #define AssertLockHeld(cs) AssertLockHeldInternal(#cs, __FILE__, __LINE__, &cs)
 #define AssertLockNotHeld(cs) AssertLockNotHeldInternal(#cs, __FILE__, __LINE__, &cs)
 
+/**
+ * Lock profiler. Mutexes constructed with a name (RecursiveMutex cs_main{"cs_main"})
+ * record, for every LOCK site, how long it waited for them and how long it held them,
+ * in fixed log2 histograms updated with relaxed atomics. Unnamed mutexes only pay a
+ * null check. See getlockstats.
+ */
+struct LockSiteStats;
+
+/** Histogram buckets: < 1us, then [2^(i-1), 2^i) us, the last one open ended */
+static const size_t LOCK_PROFILE_BUCKETS = 24;
+
+/** Stats slot of a (mutex, file, line) site, or nullptr if the table is full */
+LockSiteStats* GetLockSiteStats(const char* pszMutexName, const char* pszFile, int nLine);
+void RecordLockWait(LockSiteStats* site, int64_t nWaitNanos);
+void RecordLockHold(LockSiteStats* site, int64_t nHoldNanos);
+static const int64_t DEFAULT_LOCK_HOLD_WARN_MS = 100;
+/** Holds longer than this are logged (lock category), 0 to disable */
+void SetLockHoldWarnThreshold(int64_t nMillis);
+
+inline int64_t LockProfileNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct LockSiteProfile
+{
+    std::string strMutex;
+    std::string strFile;
+    int nLine;
+    uint64_t nAcquired;
+    uint64_t nContended;
+    uint64_t nWaitNanos;
+    uint64_t nHoldNanos;
+    uint64_t nMaxWaitNanos;
+    uint64_t nMaxHoldNanos;
+    std::vector<uint64_t> vWaitBuckets;
+    std::vector<uint64_t> vHoldBuckets;
+};
+
+/** Snapshot of the profiled sites, sorted by total hold time */
+std::vector<LockSiteProfile> GetLockProfile();
+void ResetLockProfile();
+/** Sites not profiled because the table was full */
+uint64_t GetLockProfileDroppedSites();
+
 /**
  * Template mixin that adds -Wthread-safety locking annotations and lock order
  * checking to a subset of the mutex API.
@@ -81,11 +129,20 @@ void static inline DeleteLock(void* cs) {}
 template <typename PARENT>
 class LOCKABLE AnnotatedMixin : public PARENT
 {
+private:
+    const char* const m_profile_name{nullptr};
+
 public:
+    AnnotatedMixin() = default;
+    /** Named mutexes are covered by the lock profiler */
+    explicit AnnotatedMixin(const char* pszProfileNameIn) : m_profile_name(pszProfileNameIn) {}
+
     ~AnnotatedMixin() {
         DeleteLock((void*)this);
     }
 
+    const char* ProfileName() const { return m_profile_name; }
+
     void lock() EXCLUSIVE_LOCK_FUNCTION()
     {
         PARENT::lock();
@@ -122,9 +179,33 @@ template <typename Mutex, typename Base = typename Mutex::UniqueLock>
 class SCOPED_LOCKABLE UniqueLock  : public Base
 {
 private:
+    LockSiteStats* m_profile_site{nullptr};
+    int64_t m_hold_start{0};
+
+    LockSiteStats* ProfileSite(const char* pszFile, int nLine)
+    {
+        const char* pszProfileName = static_cast<Mutex*>(Base::mutex())->ProfileName();
+        return pszProfileName ? GetLockSiteStats(pszProfileName, pszFile, nLine) : nullptr;
+    }
+
     void Enter(const char* pszName, const char* pszFile, int nLine)
     {
         EnterCritical(pszName, pszFile, nLine, (void*)(Base::mutex()));
+        m_profile_site = ProfileSite(pszFile, nLine);
+        if (m_profile_site) {
+            if (!Base::try_lock()) {
+                const int64_t nWaitStart = LockProfileNanos();
+#ifdef DEBUG_LOCKCONTENTION
+                PrintLockContention(pszName, pszFile, nLine);
+#endif
+                Base::lock();
+                m_hold_start = LockProfileNanos();
+                RecordLockWait(m_profile_site, m_hold_start - nWaitStart);
+            } else {
+                m_hold_start = LockProfileNanos();
+            }
+            return;
+        }
 #ifdef DEBUG_LOCKCONTENTION
         if (!Base::try_lock()) {
             PrintLockContention(pszName, pszFile, nLine);
@@ -139,8 +220,11 @@ private:
     {
         EnterCritical(pszName, pszFile, nLine, (void*)(Base::mutex()), true);
         Base::try_lock();
-        if (!Base::owns_lock())
+        if (!Base::owns_lock()) {
             LeaveCritical();
+        } else if ((m_profile_site = ProfileSite(pszFile, nLine))) {
+            m_hold_start = LockProfileNanos();
+        }
         return Base::owns_lock();
     }
 
@@ -166,8 +250,13 @@ public:
 
     ~UniqueLock() UNLOCK_FUNCTION()
     {
-        if (Base::owns_lock())
+        if (Base::owns_lock()) {
             LeaveCritical();
+            if (m_profile_site) {
+                Base::unlock();
+                RecordLockHold(m_profile_site, LockProfileNanos() - m_hold_start);
+            }
+        }
     }
 
     operator bool()
@@ -189,6 +278,9 @@ public:
             CheckLastCritical((void*)lock.mutex(), lockname, _guardname, _file, _line);
             lock.unlock();
             LeaveCritical();
+            if (lock.m_profile_site) {
+                RecordLockHold(lock.m_profile_site, LockProfileNanos() - lock.m_hold_start);
+            }
             lock.swap(templock);
         }
 
@@ -196,6 +288,7 @@ public:
             templock.swap(lock);
             EnterCritical(lockname.c_str(), file.c_str(), line, (void*)lock.mutex());
             lock.lock();
+            lock.m_hold_start = LockProfileNanos();
         }
 
      private:
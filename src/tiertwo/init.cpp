@@ -95,36 +95,11 @@ static void LoadBlockHashesCache(CMasternodeMan& man)
     }
 }
 
-bool LoadTierTwo(int chain_active_height, bool load_cache_files)
-{
-    // ################################# //
-    // ## Legacy Masternodes Manager ### //
-    // ################################# //
-    uiInterface.InitMessage(_("Loading masternode cache..."));
-
-    mnodeman.SetBestHeight(chain_active_height);
-    LoadBlockHashesCache(mnodeman);
-    CMasternodeDB mndb;
-    CMasternodeDB::ReadResult readResult = mndb.Read(mnodeman);
-    if (readResult == CMasternodeDB::FileError)
-        LogPrintf("Missing masternode cache file - mncache.dat, will try to recreate\n");
-    else if (readResult != CMasternodeDB::Ok) {
-        LogPrintf("Error reading mncache.dat - cached data discarded\n");
-    }
-
-    // ######################################### //
-    // ## Legacy Masternodes-Payments Manager ## //
-    // ######################################### //
-    uiInterface.InitMessage(_("Loading masternode payment cache..."));
-
-    CMasternodePaymentDB mnpayments;
-    CMasternodePaymentDB::ReadResult readResult3 = mnpayments.Read(masternodePayments);
-    if (readResult3 == CMasternodePaymentDB::FileError)
-        LogPrintf("Missing masternode payment cache - mnpayments.dat, will try to recreate\n");
-    else if (readResult3 != CMasternodePaymentDB::Ok) {
-        LogPrintf("Error reading mnpayments.dat - cached data discarded\n");
-    }
+// Whether LoadTierTwoCaches read the flat-file caches
+static bool fCacheFilesLoaded = false;
 
+bool LoadTierTwoCaches(bool load_cache_files)
+{
     // ###################################### //
     // ## Legacy Parse 'masternodes.conf'  ## //
     // ###################################### //
@@ -165,6 +140,49 @@ bool LoadTierTwo(int chain_active_height, bool load_cache_files)
         }
     }
 
+    fCacheFilesLoaded = load_cache_files;
+    return true;
+}
+
+bool LoadTierTwo(int chain_active_height, bool load_cache_files)
+{
+    // ################################# //
+    // ## Legacy Masternodes Manager ### //
+    // ################################# //
+    uiInterface.InitMessage(_("Loading masternode cache..."));
+
+    mnodeman.SetBestHeight(chain_active_height);
+    LoadBlockHashesCache(mnodeman);
+    CMasternodeDB mndb;
+    CMasternodeDB::ReadResult readResult = mndb.Read(mnodeman);
+    if (readResult == CMasternodeDB::FileError)
+        LogPrintf("Missing masternode cache file - mncache.dat, will try to recreate\n");
+    else if (readResult != CMasternodeDB::Ok) {
+        LogPrintf("Error reading mncache.dat - cached data discarded\n");
+    }
+
+    // ######################################### //
+    // ## Legacy Masternodes-Payments Manager ## //
+    // ######################################### //
+    uiInterface.InitMessage(_("Loading masternode payment cache..."));
+
+    CMasternodePaymentDB mnpayments;
+    CMasternodePaymentDB::ReadResult readResult3 = mnpayments.Read(masternodePayments);
+    if (readResult3 == CMasternodePaymentDB::FileError)
+        LogPrintf("Missing masternode payment cache - mnpayments.dat, will try to recreate\n");
+    else if (readResult3 != CMasternodePaymentDB::Ok) {
+        LogPrintf("Error reading mnpayments.dat - cached data discarded\n");
+    }
+
+    if (fCacheFilesLoaded && !load_cache_files) {
+        // The chain was reset after LoadTierTwoCaches read the flat-file caches: drop them
+        g_mmetaman.Clear();
+        g_netfulfilledman.Clear();
+        CFlatDB<CMasternodeMetaMan>(MN_META_CACHE_FILENAME, MN_META_CACHE_FILE_ID).Dump(g_mmetaman);
+        CFlatDB<CNetFulfilledRequestManager>(NET_REQUESTS_CACHE_FILENAME, NET_REQUESTS_CACHE_FILE_ID).Dump(g_netfulfilledman);
+        fCacheFilesLoaded = false;
+    }
+
     return true;
 }
 
@@ -33,7 +33,10 @@ void InitTierTwoPostCoinsCacheLoad();
 /** Initialize chain tip */
 void InitTierTwoChainTip();
 
-/** Loads from disk all the tier two related objects */
+/** Loads from disk the tier two objects that do not depend on the chain, while it loads */
+bool LoadTierTwoCaches(bool load_cache_files);
+
+/** Loads from disk the remaining tier two related objects */
 bool LoadTierTwo(int chain_active_height, bool load_cache_files);
 
 /** Register all tier two objects */
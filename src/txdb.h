@@ -83,6 +83,9 @@ public:
     bool Upgrade();
     size_t EstimateSize() const override;
 
+    //! Direct access to the underlying database, used by chainstate snapshots
+    CDBWrapper& GetRawDB() { return db; }
+
     bool BatchWrite(CCoinsMap& mapCoins,
                     const uint256& hashBlock,
                     const uint256& hashSaplingAnchor,
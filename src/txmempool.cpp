@@ -1098,7 +1098,8 @@ void CTxMemPool::queryHashes(std::vector<uint256>& vtxid)
 }
 
 static TxMempoolInfo GetInfo(CTxMemPool::indexed_transaction_set::const_iterator it) {
-    return TxMempoolInfo{it->GetSharedTx(), it->GetTime(), CFeeRate(it->GetFee(), it->GetTxSize()), it->GetModifiedFee() - it->GetFee()};
+    return TxMempoolInfo{it->GetSharedTx(), it->GetTime(), CFeeRate(it->GetFee(), it->GetTxSize()), it->GetModifiedFee() - it->GetFee(),
+                         it->GetFee(), it->GetHeight(), it->GetSpendsCoinbaseOrCoinstake(), it->GetSigOpCount()};
 }
 
 std::vector<TxMempoolInfo> CTxMemPool::infoAll() const
@@ -285,6 +285,12 @@ struct TxMempoolInfo
 
     /** The fee delta. */
     int64_t nFeeDelta;
+
+    /** Cached entry state, so a reloaded transaction doesn't need its inputs re-evaluated */
+    CAmount nFee;
+    unsigned int nHeight;
+    bool fSpendsCoinbaseOrCoinstake;
+    unsigned int nSigOps;
 };
 
 /** Reason why a transaction was removed from the mempool,
@@ -466,7 +472,7 @@ public:
      * changing the chain tip. It's necessary to keep both mutexes locked until
      * the mempool is consistent with the new chain tip and fully populated.
      */
-    mutable RecursiveMutex cs;
+    mutable RecursiveMutex cs{"mempool.cs"};
     indexed_transaction_set mapTx;
 
     typedef indexed_transaction_set::nth_index<0>::type::iterator txiter;
@@ -0,0 +1,97 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "util/parallel.h"
+
+#include "ctpl_stl.h"
+#include "sync.h"
+#include "util/threadnames.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+static Mutex cs_workerPool;
+static std::shared_ptr<ctpl::thread_pool> workerPool GUARDED_BY(cs_workerPool);
+
+namespace {
+/** The ranges of one ParallelForRanges call, claimed one at a time by the caller and the workers */
+struct ParallelRanges
+{
+    const std::function<void(size_t, size_t)>* fn{nullptr};
+    size_t nItems{0};
+    size_t nChunk{0};
+    size_t nRanges{0};
+    std::atomic<size_t> nNext{0};
+
+    std::mutex cs;
+    std::condition_variable cond;
+    size_t nDone{0};
+    std::exception_ptr error;
+
+    //! Run ranges until none is left to claim. fn is only used for a claimed range,
+    //! so a worker starting after the call returned does nothing.
+    void Run()
+    {
+        for (size_t i = nNext++; i < nRanges; i = nNext++) {
+            std::exception_ptr rangeError;
+            try {
+                (*fn)(i * nChunk, std::min(nItems, (i + 1) * nChunk));
+            } catch (...) {
+                rangeError = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(cs);
+            if (rangeError && !error) error = rangeError;
+            if (++nDone == nRanges) cond.notify_all();
+        }
+    }
+};
+} // anon namespace
+
+void StartParallelWorkers(int nThreads)
+{
+    if (nThreads <= 0) return;
+    auto pool = std::make_shared<ctpl::thread_pool>(nThreads);
+    RenameThreadPool(*pool, "bcz-worker");
+    LOCK(cs_workerPool);
+    workerPool = std::move(pool);
+}
+
+void StopParallelWorkers()
+{
+    std::shared_ptr<ctpl::thread_pool> pool;
+    WITH_LOCK(cs_workerPool, pool.swap(workerPool); );
+    // A call still running keeps the pool alive; the last holder stops the threads
+    pool.reset();
+}
+
+void ParallelForRanges(size_t nItems, size_t nMinPerRange, const std::function<void(size_t begin, size_t end)>& fn)
+{
+    std::shared_ptr<ctpl::thread_pool> pool = WITH_LOCK(cs_workerPool, return workerPool; );
+    const size_t nMaxRanges = (pool ? pool->size() : 0) + 1;
+    const size_t nWanted = std::min(nMaxRanges, nItems / std::max<size_t>(1, nMinPerRange));
+    if (nWanted <= 1) {
+        if (nItems) fn(0, nItems);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelRanges>();
+    state->fn = &fn;
+    state->nItems = nItems;
+    state->nChunk = (nItems + nWanted - 1) / nWanted;
+    state->nRanges = (nItems + state->nChunk - 1) / state->nChunk;
+    for (size_t i = 1; i < state->nRanges; i++) {
+        pool->push([state](int) { state->Run(); });
+    }
+    // The caller takes ranges too, so it never waits on workers busy with other calls
+    state->Run();
+    {
+        std::unique_lock<std::mutex> lock(state->cs);
+        state->cond.wait(lock, [&state] { return state->nDone == state->nRanges; });
+    }
+    if (state->error) std::rethrow_exception(state->error);
+}
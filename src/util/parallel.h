@@ -0,0 +1,26 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_UTIL_PARALLEL_H
+#define BCZ_UTIL_PARALLEL_H
+
+#include <functional>
+#include <stddef.h>
+
+/**
+ * Start the shared worker pool (bcz-worker threads) used by ParallelForRanges.
+ * With nThreads <= 0, or before it is started, all the work runs on the caller.
+ */
+void StartParallelWorkers(int nThreads);
+void StopParallelWorkers();
+
+/**
+ * Run fn(begin, end) over contiguous ranges covering [0, nItems), of at least
+ * nMinPerRange items each, on the calling thread and the shared worker pool.
+ * fn must be safe to run concurrently on disjoint ranges. Returns once every
+ * range is done; the first exception thrown by fn is then rethrown.
+ */
+void ParallelForRanges(size_t nItems, size_t nMinPerRange, const std::function<void(size_t begin, size_t end)>& fn);
+
+#endif // BCZ_UTIL_PARALLEL_H
@@ -621,7 +621,48 @@ const fs::path &ZC_GetParamsDir()
     return path;
 }
 
-void initZKSNARKS()
+namespace {
+enum class ZKSNARKSState {
+    LOADING,
+    READY,
+    FAILED,
+};
+
+Mutex g_zksnarks_mutex;
+std::condition_variable g_zksnarks_cv;
+ZKSNARKSState g_zksnarks_state GUARDED_BY(g_zksnarks_mutex) = ZKSNARKSState::LOADING;
+
+void SetZKSNARKSState(ZKSNARKSState state)
+{
+    LOCK(g_zksnarks_mutex);
+    g_zksnarks_state = state;
+    g_zksnarks_cv.notify_all();
+}
+} // anon namespace
+
+bool IsZKSNARKSReady(std::string* statusOut)
+{
+    LOCK(g_zksnarks_mutex);
+    if (statusOut) {
+        switch (g_zksnarks_state) {
+        case ZKSNARKSState::LOADING: *statusOut = _("Loading Sapling parameters..."); break;
+        case ZKSNARKSState::FAILED: *statusOut = _("Failed to load the Sapling parameters"); break;
+        case ZKSNARKSState::READY: statusOut->clear(); break;
+        }
+    }
+    return g_zksnarks_state == ZKSNARKSState::READY;
+}
+
+bool WaitForZKSNARKS()
+{
+    WAIT_LOCK(g_zksnarks_mutex, lock);
+    while (g_zksnarks_state == ZKSNARKSState::LOADING) {
+        g_zksnarks_cv.wait(lock);
+    }
+    return g_zksnarks_state == ZKSNARKSState::READY;
+}
+
+static void LoadZKSNARKSParams()
 {
     const fs::path& path = ZC_GetParamsDir();
     fs::path sapling_spend = path / "sapling-spend.params";
@@ -693,6 +734,17 @@ void initZKSNARKS()
     //std::cout << "### Sapling params initialized ###" << std::endl;
 }
 
+void initZKSNARKS()
+{
+    try {
+        LoadZKSNARKSParams();
+    } catch (...) {
+        SetZKSNARKSState(ZKSNARKSState::FAILED);
+        throw;
+    }
+    SetZKSNARKSState(ZKSNARKSState::READY);
+}
+
 const fs::path &GetBlocksDir()
 {
 
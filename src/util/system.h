@@ -106,6 +106,12 @@ bool CheckDataDirOption();
 const fs::path &ZC_GetParamsDir();
 // Init sapling library
 void initZKSNARKS();
+// The node loads the Sapling parameters on a background thread: anything creating or
+// verifying Sapling proofs must wait for initZKSNARKS to be done first.
+// statusOut, if given, receives the loading state to report while it is not ready.
+bool IsZKSNARKSReady(std::string* statusOut = nullptr);
+// Wait until initZKSNARKS has finished. Returns false if the parameters could not be loaded.
+bool WaitForZKSNARKS();
 void ClearDatadirCache();
 fs::path GetConfigFile(const std::string& confPath);
 fs::path GetMasternodeConfigFile();
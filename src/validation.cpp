@@ -11,15 +11,18 @@
 #include "validation.h"
 
 #include "addrman.h"
+#include "blockfilecache.h"
 #include "blocksignature.h"
 #include "util/blockstatecatcher.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "checkqueue.h"
+#include "coinstatsindex.h"
 #include "consensus/consensus.h"
 #include "consensus/merkle.h"
 #include "consensus/tx_verify.h"
 #include "consensus/validation.h"
+#include "ctpl_stl.h"
 #include "evo/specialtx_validation.h"
 #include "flatfile.h"
 #include "guiinterface.h"
@@ -39,9 +42,11 @@
 #include "txdb.h"
 #include "undo.h"
 #include "util/system.h"
+#include "util/threadnames.h"
 #include "util/validation.h"
 #include "utilmoneystr.h"
 #include "validationinterface.h"
+#include "validationtrace.h"
 #include "warnings.h"
 
 #include <future>
@@ -71,7 +76,7 @@
  * The transaction pool has a separate lock to allow reading from it and the
  * chainstate at the same time.
  */
-RecursiveMutex cs_main;
+RecursiveMutex cs_main{"cs_main"};
 
 BlockMap mapBlockIndex;
 CChain chainActive;
@@ -210,6 +215,15 @@ enum FlushStateMode {
 // See definition for documentation
 bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode);
 static FlatFileSeq BlockFileSeq();
+
+//! Read handles kept open per file sequence; well within MIN_CORE_FILEDESCRIPTORS
+static const size_t BLOCK_READER_MAX_OPEN_FILES = 8;
+//! Recently read blocks kept in memory
+static const size_t BLOCK_READER_CACHE_BYTES = 16 << 20;
+//! Recently read undo entries kept in memory (used on reorgs and by -checklevel)
+static const size_t UNDO_READER_CACHE_BYTES = 4 << 20;
+static CBlockFileReader blockFileReader(OpenBlockFile, BLOCK_READER_MAX_OPEN_FILES, BLOCK_READER_CACHE_BYTES);
+static CBlockFileReader undoFileReader(OpenUndoFile, BLOCK_READER_MAX_OPEN_FILES, UNDO_READER_CACHE_BYTES);
 static FlatFileSeq UndoFileSeq();
 
 bool CheckFinalTx(const CTransactionRef& tx, int flags)
@@ -745,13 +759,14 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos)
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("ReadBlockFromDisk : OpenBlockFile failed");
+    // Fetch the serialized block, from the cache or the history file
+    CBlockFileReader::RecordRef record;
+    if (!blockFileReader.Read(pos, 0, record))
+        return error("ReadBlockFromDisk : failed to read block at %s", pos.ToString());
 
     // Read block
     try {
+        SpanReader filein(SER_DISK, CLIENT_VERSION, *record);
         filein >> block;
     } catch (const std::exception& e) {
         return error("%s : Deserialize or I/O error - %s", __func__, e.what());
@@ -1133,14 +1148,15 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, FlatFilePos& pos, const uint25
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& hashBlock)
 {
-    // Open history file to read
-    CAutoFile filein(OpenUndoFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("%s : OpenBlockFile failed", __func__);
+    // Fetch the undo data and its trailing checksum, from the cache or the history file
+    CBlockFileReader::RecordRef record;
+    if (!undoFileReader.Read(pos, sizeof(uint256), record))
+        return error("%s : failed to read undo data at %s", __func__, pos.ToString());
 
     // Read block
     uint256 hashChecksum;
-    CHashVerifier<CAutoFile> verifier(&filein); // We need a CHashVerifier as reserializing may lose data
+    SpanReader filein(SER_DISK, CLIENT_VERSION, *record);
+    CHashVerifier<SpanReader> verifier(&filein); // We need a CHashVerifier as reserializing may lose data
     try {
         verifier << hashBlock;
         verifier >> blockundo;
@@ -1203,7 +1219,7 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
  *  When FAILED is returned, view is left in an indeterminate state. */
-DisconnectResult DisconnectBlock(CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+DisconnectResult DisconnectBlock(CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CCoinStatsDelta* pStatsDelta = nullptr)
 {
     AssertLockHeld(cs_main);
     bool fHasBestBlock = evoDb->VerifyBestBlock(pindex->GetBlockHash());
@@ -1252,6 +1268,7 @@ DisconnectResult DisconnectBlock(CBlock& block, const CBlockIndex* pindex, CCoin
                 if (tx.vout[o] != coin.out) {
                     fClean = false; // transaction output mismatch
                 }
+                if (pStatsDelta && !coin.IsSpent()) pStatsDelta->SpendCoin(out, coin);
             }
         }
 
@@ -1261,6 +1278,7 @@ DisconnectResult DisconnectBlock(CBlock& block, const CBlockIndex* pindex, CCoin
 
         // Sapling, update unspent nullifiers
         view.SetNullifiers(tx, false);
+        if (pStatsDelta && tx.IsShieldedTx()) pStatsDelta->nShieldedAmount += tx.sapData->valueBalance;
 
         // restore inputs
         CTxUndo& txundo = blockUndo.vtxundo[i - 1];
@@ -1271,9 +1289,16 @@ DisconnectResult DisconnectBlock(CBlock& block, const CBlockIndex* pindex, CCoin
         }
         for (unsigned int j = tx.vin.size(); j-- > 0;) {
             const COutPoint& out = tx.vin[j].prevout;
+            // An unclean undo overwrites a coin that is still there, take it out first
+            if (pStatsDelta) {
+                const Coin& existing = view.AccessCoin(out);
+                if (!existing.IsSpent()) pStatsDelta->SpendCoin(out, existing);
+            }
             int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
             if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
             fClean = fClean && res != DISCONNECT_UNCLEAN;
+            // The undo data may lack the height and kind, take the restored coin
+            if (pStatsDelta) pStatsDelta->AddCoin(out, view.AccessCoin(out));
         }
         // At this point, all of txundo.vprevout should have been moved out.
     }
@@ -1318,6 +1343,67 @@ void ThreadScriptCheck()
     scriptcheckqueue.Thread();
 }
 
+namespace {
+/** A block input read from the coins database by a prefetch job */
+struct PrefetchedCoin
+{
+    COutPoint outpoint;
+    Coin coin;
+    bool fFound{false};
+};
+} // anon namespace
+
+/** Below this many uncached inputs the lookups are left to ConnectBlock */
+static const size_t MIN_PREFETCH_INPUTS = 16;
+
+/**
+ * Load the inputs of a block that are not in the coins tip cache yet, reading
+ * the coins database on the special tx check threads, so that ConnectBlock
+ * finds all of them in memory instead of doing one random database read per
+ * input. LevelDB reads are thread safe, so the jobs run without cs_main; only
+ * this thread touches the coins cache. Inputs created within the block itself
+ * are skipped.
+ */
+static void PrefetchBlockInputs(const CBlock& block) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+    if (!nScriptCheckThreads || !pcoinsdbview) return;
+
+    std::unordered_set<uint256, SaltedIdHasher> setBlockTxids;
+    std::vector<PrefetchedCoin> vEntries;
+    for (const CTransactionRef& tx : block.vtx) {
+        setBlockTxids.insert(tx->GetHash());
+        if (tx->IsCoinBase()) continue;
+        for (const CTxIn& in : tx->vin) {
+            if (setBlockTxids.count(in.prevout.hash) || pcoinsTip->HaveCoinInCache(in.prevout)) continue;
+            vEntries.emplace_back();
+            vEntries.back().outpoint = in.prevout;
+        }
+    }
+    if (vEntries.size() < MIN_PREFETCH_INPUTS) return;
+
+    const CCoinsView* pdb = pcoinsdbview.get();
+    std::vector<CSpecialTxCheckJob> vJobs;
+    vJobs.reserve(vEntries.size());
+    for (PrefetchedCoin& entry : vEntries) {
+        PrefetchedCoin* pentry = &entry;
+        vJobs.emplace_back([pdb, pentry]{
+            try {
+                pentry->fFound = pdb->GetCoin(pentry->outpoint, pentry->coin);
+            } catch (const std::exception&) {
+                // Leave it to ConnectBlock, whose lookups go through the error catcher
+                pentry->fFound = false;
+            }
+            return true;
+        });
+    }
+    RunSpecialTxCheckJobs(vJobs);
+
+    for (PrefetchedCoin& entry : vEntries) {
+        if (entry.fFound) pcoinsTip->CacheFetchedCoin(entry.outpoint, std::move(entry.coin));
+    }
+}
+
 static int64_t nTimeVerify = 0;
 static int64_t nTimeProcessSpecial = 0;
 static int64_t nTimeConnect = 0;
@@ -1327,10 +1413,11 @@ static int64_t nTimeTotal = 0;
 /** Apply the effects of this block (with given index) on the UTXO set represented by coins.
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
-static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex, CCoinsViewCache& view, bool fJustCheck = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex, CCoinsViewCache& view, bool fJustCheck = false, BlockValidationTrace* pTrace = nullptr, CCoinStatsDelta* pStatsDelta = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     AssertLockHeld(cs_main);
     // Check it again in case a previous version let a bad block in
+    int64_t nTimeCheckStart = GetTimeMicros();
     if (!CheckBlock(block, state, !fJustCheck, !fJustCheck, !fJustCheck)) {
         if (state.CorruptionPossible()) {
             // We don't write down blocks to disk if they may have been
@@ -1340,6 +1427,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         }
         return error("%s: CheckBlock failed for %s: %s", __func__, block.GetHash().ToString(), FormatStateMessage(state));
     }
+    if (pTrace) pTrace->nCheckBlock += GetTimeMicros() - nTimeCheckStart;
 
     // verify that the view's current state corresponds to the previous block
     uint256 hashPrevBlock = pindex->pprev == NULL ? UINT256_ZERO : pindex->pprev->GetBlockHash();
@@ -1423,6 +1511,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     // Sapling
     SaplingMerkleTree sapling_tree;
     assert(view.GetSaplingAnchorAt(view.GetBestAnchor(), sapling_tree));
+    std::vector<libzcash::PedersenHash> vSaplingCommitments;
 
     std::vector<PrecomputedTransactionData> precomTxData;
     precomTxData.reserve(block.vtx.size()); // Required so that pointers to individual precomTxData don't get invalidated
@@ -1432,6 +1521,14 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         const CTransaction& tx = *block.vtx[i];
 
         nInputs += tx.vin.size();
+        if (pTrace) {
+            pTrace->nOutputs += tx.vout.size();
+            if (tx.IsSpecialTx()) pTrace->nSpecialTx++;
+            if (tx.IsShieldedTx()) {
+                pTrace->nShieldedSpends += tx.sapData->vShieldedSpend.size();
+                pTrace->nShieldedOutputs += tx.sapData->vShieldedOutput.size();
+            }
+        }
         nSigOps += GetLegacySigOpCount(tx);
         if (nSigOps > nMaxBlockSigOps)
             return state.DoS(100, error("ConnectBlock() : too many sigops"), REJECT_INVALID, "bad-blk-sigops");
@@ -1486,11 +1583,24 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             blockundo.vtxundo.emplace_back();
         }
         UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
+        if (pStatsDelta) {
+            if (i > 0) {
+                const CTxUndo& txundo = blockundo.vtxundo.back();
+                for (unsigned int j = 0; j < tx.vin.size(); j++) {
+                    pStatsDelta->SpendCoin(tx.vin[j].prevout, txundo.vprevout[j]);
+                }
+            }
+            for (unsigned int o = 0; o < tx.vout.size(); o++) {
+                if (tx.vout[o].scriptPubKey.IsUnspendable()) continue;
+                pStatsDelta->AddCoin(COutPoint(tx.GetHash(), o), Coin(tx.vout[o], pindex->nHeight, tx.IsCoinBase(), tx.IsCoinStake()));
+            }
+            if (tx.IsShieldedTx()) pStatsDelta->nShieldedAmount -= tx.sapData->valueBalance;
+        }
 
-        // Sapling update tree
+        // Sapling commitments, appended to the tree all at once
         if (tx.IsShieldedTx() && !tx.sapData->vShieldedOutput.empty()) {
             for(const OutputDescription &outputDescription : tx.sapData->vShieldedOutput) {
-                sapling_tree.append(outputDescription.cmu);
+                vSaplingCommitments.push_back(outputDescription.cmu);
             }
         }
 
@@ -1498,7 +1608,8 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         pos.nTxOffset += ::GetSerializeSize(tx, CLIENT_VERSION);
     }
 
-    // Push new tree anchor
+    // Update the tree and push the new anchor
+    sapling_tree.append_batch(vSaplingCommitments);
     view.PushAnchor(sapling_tree);
 
     // Verify header correctness
@@ -1516,6 +1627,11 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
     int64_t nTime1 = GetTimeMicros();
     nTimeConnect += nTime1 - nTimeStart;
+    if (pTrace) {
+        pTrace->nTx = block.vtx.size();
+        pTrace->nInputs = nInputs;
+        pTrace->nConnectInputs = nTime1 - nTimeStart;
+    }
     LogPrint(BCLog::BENCHMARK, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs]\n", (unsigned)block.vtx.size(), 0.001 * (nTime1 - nTimeStart), 0.001 * (nTime1 - nTimeStart) / block.vtx.size(), nInputs <= 1 ? 0 : 0.001 * (nTime1 - nTimeStart) / (nInputs - 1), nTimeConnect * 0.000001);
 
     //PoW phase redistributed fees to miner. PoS stage destroys fees.
@@ -1548,6 +1664,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
     int64_t nTime2 = GetTimeMicros();
     nTimeVerify += nTime2 - nTimeStart;
+    if (pTrace) pTrace->nVerifyScripts = nTime2 - nTime1;
     LogPrint(BCLog::BENCHMARK, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs]\n", nInputs - 1, 0.001 * (nTime2 - nTimeStart), nInputs <= 1 ? 0 : 0.001 * (nTime2 - nTimeStart) / (nInputs - 1), nTimeVerify * 0.000001);
 
     if (!ProcessSpecialTxsInBlock(block, pindex, &view, state, fJustCheck)) {
@@ -1555,6 +1672,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     }
     int64_t nTime3 = GetTimeMicros();
     nTimeProcessSpecial += nTime3 - nTime2;
+    if (pTrace) pTrace->nSpecialTxes = nTime3 - nTime2;
     LogPrint(BCLog::BENCHMARK, "    - Process special tx: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeProcessSpecial * 0.000001);
 
     //IMPORTANT NOTE: Nothing before this point should actually store to disk (or even memory)
@@ -1589,6 +1707,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
     int64_t nTime4 = GetTimeMicros();
     nTimeIndex += nTime4 - nTime3;
+    if (pTrace) pTrace->nIndex = nTime4 - nTime3;
     LogPrint(BCLog::BENCHMARK, "    - Index writing: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeIndex * 0.000001);
 
     return true;
@@ -1682,10 +1801,13 @@ bool static FlushStateToDisk(CValidationState& state, FlushStateMode mode)
             if (!evoDb->CommitRootTransaction()) {
                 return AbortNode(state, "Failed to commit EvoDB");
             }
+            if (g_coinStatsIndex && !g_coinStatsIndex->Flush()) {
+                return AbortNode(state, "Failed to write coin statistics index");
+            }
             nLastFlush = nNow;
-            // Update money supply on memory, reading data from disk
+            // Update money supply on memory, reading data from disk (or from the coin statistics index)
             if (!ShutdownRequested() && !IsInitialBlockDownload()) {
-                MoneySupply.Update(pcoinsTip->GetTotalAmount(), chainActive.Height());
+                MoneySupply.Update(g_coinStatsIndex ? g_coinStatsIndex->GetTotalAmount() : pcoinsTip->GetTotalAmount(), chainActive.Height());
             }
         }
         if ((mode == FLUSH_STATE_ALWAYS || mode == FLUSH_STATE_PERIODIC) && nNow > nLastSetChain + (int64_t)DATABASE_WRITE_INTERVAL * 1000000) {
@@ -1783,11 +1905,13 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
 
         CCoinsViewCache view(pcoinsTip.get());
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
-        if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK)
+        CCoinStatsDelta statsDelta;
+        if (DisconnectBlock(block, pindexDelete, view, g_coinStatsIndex ? &statsDelta : nullptr) != DISCONNECT_OK)
             return error("DisconnectTip() : DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
         bool flushed = view.Flush();
         assert(flushed);
         dbTx->Commit();
+        if (g_coinStatsIndex) g_coinStatsIndex->BlockDisconnected(pindexDelete, statsDelta);
     }
     LogPrint(BCLog::BENCHMARK, "- Disconnect block: %.2fms\n", (GetTimeMicros() - nStart) * 0.001);
     const uint256& saplingAnchorAfterDisconnect = pcoinsTip->GetBestAnchor();
@@ -1833,6 +1957,7 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
 }
 
 static int64_t nTimeReadFromDisk = 0;
+static int64_t nTimePrefetchInputs = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
@@ -1841,6 +1966,7 @@ static int64_t nTimePostConnect = 0;
 struct PerBlockConnectTrace {
     CBlockIndex* pindex = nullptr;
     std::shared_ptr<const CBlock> pblock;
+    BlockValidationTrace validationTrace;
     PerBlockConnectTrace() {}
 };
 /**
@@ -1857,12 +1983,13 @@ private:
 public:
     ConnectTrace() : blocksConnected(1) {}
 
-    void BlockConnected(CBlockIndex* pindex, std::shared_ptr<const CBlock> pblock) {
+    void BlockConnected(CBlockIndex* pindex, std::shared_ptr<const CBlock> pblock, BlockValidationTrace&& validationTrace) {
         assert(!blocksConnected.back().pindex);
         assert(pindex);
         assert(pblock);
         blocksConnected.back().pindex = pindex;
         blocksConnected.back().pblock = std::move(pblock);
+        blocksConnected.back().validationTrace = std::move(validationTrace);
         blocksConnected.emplace_back();
     }
 
@@ -1906,28 +2033,41 @@ bool static ConnectTip(CValidationState& state, CBlockIndex* pindexNew, const st
     // Apply the block atomically to the chain state.
     int64_t nTime2 = GetTimeMicros();
     nTimeReadFromDisk += nTime2 - nTime1;
+    BlockValidationTrace trace;
+    BlockValidationTrace* pTrace = g_blockTraces.IsEnabled() ? &trace : nullptr;
+    trace.nReadBlock = nTime2 - nTime1;
     int64_t nTime3;
     LogPrint(BCLog::BENCHMARK, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * 0.001, nTimeReadFromDisk * 0.000001);
+    PrefetchBlockInputs(blockConnecting);
+    int64_t nTimePrefetched = GetTimeMicros();
+    nTimePrefetchInputs += nTimePrefetched - nTime2;
+    trace.nPrefetchInputs = nTimePrefetched - nTime2;
+    LogPrint(BCLog::BENCHMARK, "  - Prefetch inputs: %.2fms [%.2fs]\n", (nTimePrefetched - nTime2) * 0.001, nTimePrefetchInputs * 0.000001);
     {
         auto dbTx = evoDb->BeginTransaction();
 
         CCoinsViewCache view(pcoinsTip.get());
-        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, false);
+        CCoinStatsDelta statsDelta;
+        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, false, pTrace, g_coinStatsIndex ? &statsDelta : nullptr);
+        int64_t nTimeSignals = GetTimeMicros();
         GetMainSignals().BlockChecked(blockConnecting, state);
+        trace.nSignals = GetTimeMicros() - nTimeSignals;
         if (!rv) {
             if (state.IsInvalid())
                 InvalidBlockFound(pindexNew, state);
             return error("%s: ConnectBlock %s failed, %s", __func__, pindexNew->GetBlockHash().ToString(), FormatStateMessage(state));
         }
         nTime3 = GetTimeMicros();
-        nTimeConnectTotal += nTime3 - nTime2;
-        LogPrint(BCLog::BENCHMARK, "  - Connect total: %.2fms [%.2fs]\n", (nTime3 - nTime2) * 0.001, nTimeConnectTotal * 0.000001);
+        nTimeConnectTotal += nTime3 - nTimePrefetched;
+        LogPrint(BCLog::BENCHMARK, "  - Connect total: %.2fms [%.2fs]\n", (nTime3 - nTimePrefetched) * 0.001, nTimeConnectTotal * 0.000001);
         bool flushed = view.Flush();
         assert(flushed);
         dbTx->Commit();
+        if (g_coinStatsIndex) g_coinStatsIndex->BlockConnected(pindexNew, statsDelta);
     }
     int64_t nTime4 = GetTimeMicros();
     nTimeFlush += nTime4 - nTime3;
+    trace.nFlush = nTime4 - nTime3;
     LogPrint(BCLog::BENCHMARK, "  - Flush: %.2fms [%.2fs]\n", (nTime4 - nTime3) * 0.001, nTimeFlush * 0.000001);
 
     // Write the chain state to disk, if necessary. Always write to disk if this is the first of a new file.
@@ -1938,6 +2078,7 @@ bool static ConnectTip(CValidationState& state, CBlockIndex* pindexNew, const st
         return false;
     int64_t nTime5 = GetTimeMicros();
     nTimeChainState += nTime5 - nTime4;
+    trace.nChainState = nTime5 - nTime4;
     LogPrint(BCLog::BENCHMARK, "  - Writing chainstate: %.2fms [%.2fs]\n", (nTime5 - nTime4) * 0.001, nTimeChainState * 0.000001);
 
     // Remove conflicting transactions from the mempool.
@@ -1958,7 +2099,15 @@ bool static ConnectTip(CValidationState& state, CBlockIndex* pindexNew, const st
     LogPrint(BCLog::BENCHMARK, "  - Connect postprocess: %.2fms [%.2fs]\n", (nTime6 - nTime5) * 0.001, nTimePostConnect * 0.000001);
     LogPrint(BCLog::BENCHMARK, "- Connect block: %.2fms [%.2fs]\n", (nTime6 - nTime1) * 0.001, nTimeTotal * 0.000001);
 
-    connectTrace.BlockConnected(pindexNew, std::move(pthisBlock));
+    if (pTrace) {
+        trace.hashBlock = pindexNew->GetBlockHash();
+        trace.nHeight = pindexNew->nHeight;
+        trace.nTimeConnected = GetTime();
+        trace.nSize = ::GetSerializeSize(blockConnecting, PROTOCOL_VERSION);
+        trace.nPostConnect = nTime6 - nTime5;
+        trace.nTotal = nTime6 - nTime1;
+    }
+    connectTrace.BlockConnected(pindexNew, std::move(pthisBlock), std::move(trace));
     return true;
 }
 
@@ -2188,9 +2337,18 @@ bool ActivateBestChain(CValidationState& state, std::shared_ptr<const CBlock> pb
                 }
                 pindexNewTip = chainActive.Tip();
 
-                for (const PerBlockConnectTrace& trace : connectTrace.GetBlocksConnected()) {
+                for (PerBlockConnectTrace& trace : connectTrace.GetBlocksConnected()) {
                     assert(trace.pblock && trace.pindex);
+                    int64_t nTimeSignals = GetTimeMicros();
                     GetMainSignals().BlockConnected(trace.pblock, trace.pindex);
+                    if (g_blockTraces.IsEnabled()) {
+                        BlockValidationTrace& validationTrace = trace.validationTrace;
+                        const int64_t nSignals = GetTimeMicros() - nTimeSignals;
+                        validationTrace.nSignals += nSignals;
+                        validationTrace.nTotal += nSignals;
+                        g_blockTraces.Push(validationTrace);
+                        GetMainSignals().BlockValidationTraced(validationTrace);
+                    }
                 }
             } while (!chainActive.Tip() || (starting_tip && CBlockIndexWorkComparator()(chainActive.Tip(), starting_tip)));
             if (!blocks_connected) return true;
@@ -2693,7 +2851,7 @@ bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& sta
     return true;
 }
 
-bool ContextualCheckBlock(const CBlock& block, CValidationState& state, CBlockIndex* const pindexPrev)
+bool ContextualCheckBlock(const CBlock& block, CValidationState& state, CBlockIndex* const pindexPrev, int64_t* pnSaplingMicros)
 {
     const int nHeight = pindexPrev == nullptr ? 0 : pindexPrev->nHeight + 1;
     const CChainParams& chainparams = Params();
@@ -2702,9 +2860,12 @@ bool ContextualCheckBlock(const CBlock& block, CValidationState& state, CBlockIn
     for (const auto& tx : block.vtx) {
 
         // Check transaction contextually against consensus rules at block height
+        // (this is where the Sapling proofs and signatures are verified)
+        const int64_t nTimeStart = pnSaplingMicros && tx->IsShieldedTx() ? GetTimeMicros() : 0;
         if (!ContextualCheckTransaction(tx, state, chainparams, nHeight, true /* isMined */, IsInitialBlockDownload())) {
             return false;
         }
+        if (nTimeStart) *pnSaplingMicros += GetTimeMicros() - nTimeStart;
 
         if (!IsFinalTx(tx, nHeight, block.GetBlockTime())) {
             return state.DoS(10, false, REJECT_INVALID, "bad-txns-nonfinal", false, "non-final transaction");
@@ -2960,13 +3121,19 @@ static bool AcceptBlock(const CBlock& block, CValidationState& state, CBlockInde
         return true;
     }
 
-    if (!CheckBlock(block, state) || !ContextualCheckBlock(block, state, pindex->pprev)) {
+    const int64_t nTimeStart = GetTimeMicros();
+    const bool fChecked = CheckBlock(block, state);
+    const int64_t nTimeCheckBlock = GetTimeMicros() - nTimeStart;
+    int64_t nTimeSapling = 0;
+    if (!fChecked || !ContextualCheckBlock(block, state, pindex->pprev, &nTimeSapling)) {
         if (state.IsInvalid() && !state.CorruptionPossible()) {
             pindex->nStatus |= BLOCK_FAILED_VALID;
             setDirtyBlockIndex.insert(pindex);
         }
         return error("%s: %s", __func__, FormatStateMessage(state));
     }
+    g_blockTraces.AddPending(pindex->GetBlockHash(), nTimeCheckBlock,
+                             GetTimeMicros() - nTimeStart - nTimeCheckBlock - nTimeSapling, nTimeSapling);
 
     int nHeight = pindex->nHeight;
 
@@ -3062,10 +3229,12 @@ bool ProcessNewBlock(const std::shared_ptr<const CBlock>& pblock, const FlatFile
         // CheckBlock requires cs_main lock
         LOCK(cs_main);
         CValidationState state;
+        const int64_t nTimeCheck = GetTimeMicros();
         if (!CheckBlock(*pblock, state)) {
             GetMainSignals().BlockChecked(*pblock, state);
             return error ("%s : CheckBlock FAILED for block %s, %s", __func__, pblock->GetHash().GetHex(), FormatStateMessage(state));
         }
+        g_blockTraces.AddPending(pblock->GetHash(), GetTimeMicros() - nTimeCheck, 0, 0);
 
         // Store to disk
         CBlockIndex* pindex = nullptr;
@@ -3525,6 +3694,8 @@ void UnloadBlockIndex()
     nBlockSequenceId = 1;
     setDirtyBlockIndex.clear();
     setDirtyFileInfo.clear();
+    blockFileReader.Clear();
+    undoFileReader.Clear();
 
     for (BlockMap::value_type& entry : mapBlockIndex) {
         delete entry.second;
@@ -3591,6 +3762,23 @@ bool LoadGenesisBlock()
 }
 
 
+/** Raw blocks scanned ahead of the one being connected, while their decoding runs on the pool */
+static const unsigned int IMPORT_QUEUE_BLOCKS = 64;
+/** Bytes of the file spanned by the queued blocks, bounded so a failed decode can still rewind */
+static const uint64_t IMPORT_QUEUE_BYTES = 4 * MAX_BLOCK_SIZE;
+/** Upper bound on the threads decoding and hashing blocks during import */
+static const int MAX_IMPORT_DECODE_THREADS = 8;
+
+namespace {
+/** A block located in an external file, queued for decoding. */
+struct PendingImportBlock
+{
+    FlatFilePos pos;           // position of the block payload (only used for reindex)
+    uint64_t nScanRewind;      // where to resume scanning if the block turns out to be undecodable
+    std::future<std::shared_ptr<const CBlock>> decoded;
+};
+} // anon namespace
+
 bool LoadExternalBlockFile(FILE* fileIn, FlatFilePos* dbp)
 {
     // Map of disk positions for blocks with unknown parent (only used for reindex)
@@ -3601,55 +3789,101 @@ bool LoadExternalBlockFile(FILE* fileIn, FlatFilePos* dbp)
     BlockStateCatcher stateCatcher(UINT256_ZERO);
     stateCatcher.registerEvent();
 
+    // The loader thread only scans the file for blocks and connects them in file order;
+    // deserialization (which hashes every transaction) runs ahead on this pool.
+    ctpl::thread_pool decodePool(std::max(1, std::min(GetNumCores() - 1, MAX_IMPORT_DECODE_THREADS)));
+    RenameThreadPool(decodePool, "bcz-blkdecode");
+
     int nLoaded = 0;
     try {
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2 * MAX_BLOCK_SIZE, MAX_BLOCK_SIZE + 8, SER_DISK, CLIENT_VERSION);
+        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor.
+        // The rewind window covers all queued blocks, so scanning can restart after any of them.
+        const uint64_t nRewindLimit = IMPORT_QUEUE_BYTES + MAX_BLOCK_SIZE + 8;
+        CBufferedFile blkdat(fileIn, 2 * nRewindLimit, nRewindLimit, SER_DISK, CLIENT_VERSION);
+        std::deque<PendingImportBlock> queue;
         uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
+        bool fScanDone = false;
+        while (!fScanDone || !queue.empty()) {
             boost::this_thread::interruption_point();
 
-            blkdat.SetPos(nRewind);
-            nRewind++;         // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
-                blkdat.FindByte(Params().MessageStart()[0]);
-                nRewind = blkdat.GetPos()+1;
-                blkdat >> buf;
-                if (memcmp(buf, Params().MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
-                    continue;
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > MAX_BLOCK_SIZE)
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
-                break;
+            // Scan ahead and hand raw blocks over to the decoding pool
+            while (!fScanDone && queue.size() < IMPORT_QUEUE_BLOCKS &&
+                   (queue.empty() || blkdat.GetPos() < queue.front().nScanRewind + IMPORT_QUEUE_BYTES)) {
+                if (blkdat.eof()) {
+                    fScanDone = true;
+                    break;
+                }
+                blkdat.SetPos(nRewind);
+                nRewind++;         // start one byte further next time, in case of failure
+                blkdat.SetLimit(); // remove former limit
+                unsigned int nSize = 0;
+                try {
+                    // locate a header
+                    unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
+                    blkdat.FindByte(Params().MessageStart()[0]);
+                    nRewind = blkdat.GetPos()+1;
+                    blkdat >> buf;
+                    if (memcmp(buf, Params().MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
+                        continue;
+                    // read size
+                    blkdat >> nSize;
+                    if (nSize < 80 || nSize > MAX_BLOCK_SIZE)
+                        continue;
+                } catch (const std::exception&) {
+                    // no valid block header found; don't complain
+                    fScanDone = true;
+                    break;
+                }
+                try {
+                    // read raw block
+                    PendingImportBlock pending;
+                    if (dbp)
+                        pending.pos = *dbp;
+                    pending.pos.nPos = blkdat.GetPos();
+                    pending.nScanRewind = nRewind;
+                    auto raw = std::make_shared<CDataStream>(SER_DISK, CLIENT_VERSION);
+                    raw->resize(nSize);
+                    blkdat.read(raw->data(), nSize);
+                    nRewind = blkdat.GetPos();
+                    pending.decoded = decodePool.push([raw](int threadId) {
+                        auto block = std::make_shared<CBlock>();
+                        *raw >> *block;
+                        return std::shared_ptr<const CBlock>(std::move(block));
+                    });
+                    queue.emplace_back(std::move(pending));
+                } catch (const std::exception& e) {
+                    LogPrintf("%s : Deserialize or I/O error - %s", __func__, e.what());
+                }
             }
+
+            if (queue.empty()) continue;
+            PendingImportBlock pending = std::move(queue.front());
+            queue.pop_front();
+            FlatFilePos* pblockPos = dbp ? &pending.pos : nullptr;
+
             try {
-                // read block
-                uint64_t nBlockPos = blkdat.GetPos();
-                if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                blkdat.SetPos(nBlockPos);
-                CBlock block;
-                blkdat >> block;
-                nRewind = blkdat.GetPos();
-
-                uint256 hash = block.GetHash();
+                std::shared_ptr<const CBlock> block_ptr;
+                try {
+                    block_ptr = pending.decoded.get();
+                } catch (const std::exception&) {
+                    // Blocks queued after this one were located assuming its size was right: drop
+                    // them and scan again from just past this block's magic bytes.
+                    queue.clear();
+                    nRewind = pending.nScanRewind;
+                    fScanDone = false;
+                    throw;
+                }
+
+                uint256 hash = block_ptr->GetHash();
                 CBlockIndex* pindex{nullptr};
                 {
                     LOCK(cs_main);
                     // detect out of order blocks, and store them for later
-                    if (hash != Params().GetConsensus().hashGenesisBlock && !LookupBlockIndex(block.hashPrevBlock)) {
+                    if (hash != Params().GetConsensus().hashGenesisBlock && !LookupBlockIndex(block_ptr->hashPrevBlock)) {
                         LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__,
-                                hash.ToString(), block.hashPrevBlock.ToString());
+                                hash.ToString(), block_ptr->hashPrevBlock.ToString());
                         if (dbp)
-                            mapBlocksUnknownParent.emplace(block.hashPrevBlock, *dbp);
+                            mapBlocksUnknownParent.emplace(block_ptr->hashPrevBlock, pending.pos);
                         continue;
                     }
 
@@ -3658,9 +3892,8 @@ bool LoadExternalBlockFile(FILE* fileIn, FlatFilePos* dbp)
 
                 // process in case the block isn't known yet
                 if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
-                    std::shared_ptr<const CBlock> block_ptr = std::make_shared<const CBlock>(block);
-                    stateCatcher.setBlockHash(block_ptr->GetHash());
-                    if (ProcessNewBlock(block_ptr, dbp)) {
+                    stateCatcher.setBlockHash(hash);
+                    if (ProcessNewBlock(block_ptr, pblockPos)) {
                         nLoaded++;
                     }
                     if (stateCatcher.stateErrorFound()) {
@@ -3671,21 +3904,21 @@ bool LoadExternalBlockFile(FILE* fileIn, FlatFilePos* dbp)
                 }
 
                 // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
+                std::deque<uint256> children;
+                children.push_back(hash);
+                while (!children.empty()) {
+                    uint256 head = children.front();
+                    children.pop_front();
                     std::pair<std::multimap<uint256, FlatFilePos>::iterator, std::multimap<uint256, FlatFilePos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
                     while (range.first != range.second) {
                         std::multimap<uint256, FlatFilePos>::iterator it = range.first;
-                        if (ReadBlockFromDisk(block, it->second)) {
-                            LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, block.GetHash().ToString(),
+                        std::shared_ptr<CBlock> pchild = std::make_shared<CBlock>();
+                        if (ReadBlockFromDisk(*pchild, it->second)) {
+                            LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pchild->GetHash().ToString(),
                                 head.ToString());
-                            std::shared_ptr<const CBlock> block_ptr = std::make_shared<const CBlock>(block);
-                            if (ProcessNewBlock(block_ptr, &it->second)) {
+                            if (ProcessNewBlock(pchild, &it->second)) {
                                 nLoaded++;
-                                queue.emplace_back(block.GetHash());
+                                children.emplace_back(pchild->GetHash());
                             }
                         }
                         range.first++;
@@ -3869,7 +4102,144 @@ CBlockFileInfo* GetBlockFileInfo(size_t n)
     return &vinfoBlockFile.at(n);
 }
 
-static const uint64_t MEMPOOL_DUMP_VERSION = 1;
+//! Version 1 dumps only carry the transactions; version 2 adds the tip and the cached entry state.
+//! Nodes older than version 2 do not load a version 2 dump, they start with an empty mempool.
+static const uint64_t MEMPOOL_DUMP_VERSION_NO_TIP = 1;
+static const uint64_t MEMPOOL_DUMP_VERSION = 2;
+//! Transactions handled per cs_main acquisition while loading a mempool dump
+static const unsigned int MEMPOOL_LOAD_BATCH_SIZE = 100;
+
+namespace {
+struct MempoolDumpEntry
+{
+    CTransactionRef tx;
+    int64_t nTime;
+    int64_t nFeeDelta;
+    // Only set by version 2 dumps
+    CAmount nFee{0};
+    unsigned int nHeight{0};
+    bool fSpendsCoinbaseOrCoinstake{false};
+    unsigned int nSigOps{0};
+};
+} // anon namespace
+
+/**
+ * Re-add a transaction from a mempool dump written at the current tip. Its scripts,
+ * Sapling proofs and special payload were verified against this same chain state
+ * before the dump, so only those are skipped: the policy checks, which depend on
+ * this node's settings, and the checks depending on what has been reloaded so far
+ * are repeated; the cached fee and sigop state is reused.
+ */
+static bool AddDumpedEntryToMemoryPool(CTxMemPool& pool, CValidationState& state, const MempoolDumpEntry& e) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+    const CTransaction& tx = *e.tx;
+    const uint256& hash = tx.GetHash();
+    const int nextBlockHeight = chainActive.Height() + 1;
+
+    if (tx.IsCoinBase() || tx.IsCoinStake() || tx.IsQuorumCommitmentTx())
+        return state.DoS(100, false, REJECT_INVALID, "not-a-loose-tx");
+    if (sporkManager.IsSporkActive(SPORK_7_SAPLING_MAINTENANCE) && tx.IsShieldedTx())
+        return state.DoS(10, false, REJECT_INVALID, "bad-tx-sapling-maintenance");
+    if (!CheckTransaction(tx, state, !sporkManager.IsSporkActive(SPORK_26_COLDSTAKING_MAINTENANCE)))
+        return false;
+    if (!CheckFinalTx(e.tx, STANDARD_LOCKTIME_VERIFY_FLAGS))
+        return state.DoS(0, false, REJECT_NONSTANDARD, "non-final");
+    std::string reason;
+    if (fRequireStandard && !IsStandardTx(e.tx, nextBlockHeight, reason))
+        return state.DoS(0, false, REJECT_NONSTANDARD, reason);
+
+    {
+        LOCK(pool.cs);
+        if (pool.exists(hash))
+            return state.Invalid(false, REJECT_ALREADY_KNOWN, "txn-already-in-mempool");
+        if (pool.existsProviderTxConflict(tx))
+            return state.DoS(0, false, REJECT_DUPLICATE, "protx-dup");
+        for (const CTxIn& txin : tx.vin) {
+            if (pool.mapNextTx.count(txin.prevout))
+                return state.Invalid(false, REJECT_CONFLICT, "txn-mempool-conflict");
+        }
+        if (tx.IsShieldedTx()) {
+            for (const auto& sd : tx.sapData->vShieldedSpend) {
+                if (pool.nullifierExists(sd.nullifier))
+                    return state.Invalid(false, REJECT_INVALID, "bad-txns-nullifier-double-spent");
+            }
+        }
+
+        CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool);
+        CCoinsViewCache view(&viewMemPool);
+        for (const CTxIn& txin : tx.vin) {
+            if (!view.HaveCoin(txin.prevout))
+                return state.Invalid(false, REJECT_INVALID, "bad-txns-inputs-missingorspent");
+        }
+        if (!view.HaveShieldedRequirements(tx))
+            return state.Invalid(false, REJECT_DUPLICATE, "bad-txns-shielded-requirements-not-met");
+        // The inputs are all known here, so the cached fee is cheap to double check
+        if (view.GetValueIn(tx) - tx.GetValueOut() != e.nFee)
+            return state.Invalid(false, REJECT_INVALID, "bad-txns-cached-fee-mismatch");
+        if (fRequireStandard && !AreInputsStandard(tx, view))
+            return state.Invalid(false, REJECT_NONSTANDARD, "bad-txns-nonstandard-inputs");
+        if (e.nSigOps > MAX_TX_SIGOPS)
+            return state.DoS(0, false, REJECT_NONSTANDARD, "bad-txns-too-many-sigops", false,
+                strprintf("%d > %d", e.nSigOps, MAX_TX_SIGOPS));
+
+        CTxMemPoolEntry entry(e.tx, e.nFee, e.nTime, e.nHeight, e.fSpendsCoinbaseOrCoinstake, e.nSigOps);
+        // The fee policy may have changed since the dump, as in AcceptToMemoryPool
+        const unsigned int nSize = entry.GetTxSize();
+        const CAmount txMinFee = GetMinRelayFee(tx, pool, nSize);
+        if (e.nFee < txMinFee)
+            return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "insufficient fee", false,
+                strprintf("%d < %d", e.nFee, txMinFee));
+        if (e.nFee < ::minRelayTxFee.GetFee(nSize))
+            return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "min relay fee not met");
+        CTxMemPool::setEntries setAncestors;
+        size_t nLimitAncestors = gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT);
+        size_t nLimitAncestorSize = gArgs.GetArg("-limitancestorsize", DEFAULT_ANCESTOR_SIZE_LIMIT)*1000;
+        size_t nLimitDescendants = gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT);
+        size_t nLimitDescendantSize = gArgs.GetArg("-limitdescendantsize", DEFAULT_DESCENDANT_SIZE_LIMIT)*1000;
+        std::string errString;
+        if (!pool.CalculateMemPoolAncestors(entry, setAncestors, nLimitAncestors, nLimitAncestorSize, nLimitDescendants, nLimitDescendantSize, errString)) {
+            return state.DoS(0, false, REJECT_NONSTANDARD, "too-long-mempool-chain", false, errString);
+        }
+        // Reloaded transactions don't count for fee estimation, as when revalidated
+        pool.addUnchecked(hash, entry, setAncestors, false);
+    }
+
+    GetMainSignals().TransactionAddedToMempool(e.tx);
+    return true;
+}
+
+/**
+ * Verify the input scripts of a batch of dumped transactions on the script check
+ * threads, storing the results in the signature cache, so that the following
+ * AcceptToMemoryPool calls only hit the cache. Failures are ignored here: they
+ * are reported when the transaction itself is revalidated.
+ */
+static void WarmSignatureCacheForBatch(CTxMemPool& pool, const std::vector<MempoolDumpEntry>& batch) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+    if (!nScriptCheckThreads) return;
+
+    std::vector<PrecomputedTransactionData> precomTxData;
+    precomTxData.reserve(batch.size());
+    std::vector<CScriptCheck> vChecks;
+    {
+        LOCK(pool.cs);
+        CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool);
+        for (const MempoolDumpEntry& e : batch) {
+            precomTxData.emplace_back(*e.tx);
+            for (unsigned int i = 0; i < e.tx->vin.size(); i++) {
+                Coin coin;
+                // Inputs created by earlier transactions of the same batch are not known yet
+                if (!viewMemPool.GetCoin(e.tx->vin[i].prevout, coin)) continue;
+                vChecks.emplace_back(coin.out, *e.tx, i, STANDARD_SCRIPT_VERIFY_FLAGS, true, &precomTxData.back());
+            }
+        }
+    }
+    CCheckQueueControl<CScriptCheck> control(&scriptcheckqueue);
+    control.Add(vChecks);
+    control.Wait();
+}
 
 bool LoadMempool(CTxMemPool& pool)
 {
@@ -3885,39 +4255,73 @@ bool LoadMempool(CTxMemPool& pool)
     int64_t skipped = 0;
     int64_t failed = 0;
     int64_t nNow = GetTime();
+    bool fSameTip = false;
 
     try {
         uint64_t version;
         file >> version;
-        if (version != MEMPOOL_DUMP_VERSION) {
+        if (version != MEMPOOL_DUMP_VERSION && version != MEMPOOL_DUMP_VERSION_NO_TIP) {
             return false;
         }
+        uint256 hashTip;
+        if (version >= MEMPOOL_DUMP_VERSION) {
+            file >> hashTip;
+            LOCK(cs_main);
+            fSameTip = chainActive.Tip() && chainActive.Tip()->GetBlockHash() == hashTip;
+        }
         uint64_t num;
         file >> num;
-        while (num--) {
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> tx;
-            file >> nTime;
-            file >> nFeeDelta;
-
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
-            }
-            CValidationState state;
-            if (nTime + nExpiryTimeout > nNow) {
-                LOCK(cs_main);
-                AcceptToMemoryPoolWithTime(pool, state, tx, true, NULL, nTime);
-                if (state.IsValid()) {
-                    ++count;
+        std::vector<MempoolDumpEntry> batch;
+        batch.reserve(MEMPOOL_LOAD_BATCH_SIZE);
+        while (num || !batch.empty()) {
+            // Read up to a batch of unexpired transactions
+            while (num && batch.size() < MEMPOOL_LOAD_BATCH_SIZE) {
+                num--;
+                MempoolDumpEntry e;
+                file >> e.tx;
+                file >> e.nTime;
+                file >> e.nFeeDelta;
+                if (version >= MEMPOOL_DUMP_VERSION) {
+                    file >> e.nFee;
+                    file >> e.nHeight;
+                    file >> e.fSpendsCoinbaseOrCoinstake;
+                    file >> e.nSigOps;
+                }
+                if (e.nTime + nExpiryTimeout > nNow) {
+                    batch.emplace_back(std::move(e));
                 } else {
-                    ++failed;
+                    ++skipped;
+                }
+            }
+
+            for (const MempoolDumpEntry& e : batch) {
+                CAmount amountdelta = e.nFeeDelta;
+                if (amountdelta) {
+                    pool.PrioritiseTransaction(e.tx->GetHash(), amountdelta);
+                }
+            }
+
+            {
+                LOCK(cs_main);
+                if (!fSameTip) {
+                    WarmSignatureCacheForBatch(pool, batch);
+                }
+                for (const MempoolDumpEntry& e : batch) {
+                    CValidationState state;
+                    bool fAccepted = fSameTip && AddDumpedEntryToMemoryPool(pool, state, e);
+                    if (!fAccepted) {
+                        // Fall back to full revalidation for anything the fast path refused
+                        state = CValidationState();
+                        fAccepted = AcceptToMemoryPoolWithTime(pool, state, e.tx, true, NULL, e.nTime);
+                    }
+                    if (fAccepted) {
+                        ++count;
+                    } else {
+                        ++failed;
+                    }
                 }
-            } else {
-                ++skipped;
             }
+            batch.clear();
             if (ShutdownRequested())
                 return false;
         }
@@ -3932,7 +4336,14 @@ bool LoadMempool(CTxMemPool& pool)
         return false;
     }
 
-    LogPrintf("Imported mempool transactions from disk: %i successes, %i failed, %i expired\n", count, failed, skipped);
+    if (fSameTip) {
+        // Entries reloaded without revalidation skipped the per-transaction size limiting
+        LOCK(cs_main);
+        LimitMempoolSize(pool, gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000, nExpiryTimeout);
+    }
+
+    LogPrintf("Imported mempool transactions from disk (%s): %i successes, %i failed, %i expired\n",
+              fSameTip ? "same tip" : "revalidated", count, failed, skipped);
     return true;
 }
 
@@ -3942,12 +4353,17 @@ bool DumpMempool(const CTxMemPool& pool)
 
     std::map<uint256, CAmount> mapDeltas;
     std::vector<TxMempoolInfo> vinfo;
+    uint256 hashTip;
 
     static Mutex dump_mutex;
     LOCK(dump_mutex);
 
     {
-        LOCK(pool.cs);
+        // The tip and the pool must match, so that a reload can trust the entries
+        LOCK2(cs_main, pool.cs);
+        if (chainActive.Tip()) {
+            hashTip = chainActive.Tip()->GetBlockHash();
+        }
         for (const auto &i : pool.mapDeltas) {
             mapDeltas[i.first] = i.second;
         }
@@ -3966,12 +4382,17 @@ bool DumpMempool(const CTxMemPool& pool)
 
         uint64_t version = MEMPOOL_DUMP_VERSION;
         file << version;
+        file << hashTip;
 
         file << (uint64_t)vinfo.size();
         for (const auto& i : vinfo) {
             file << i.tx;
             file << (int64_t)i.nTime;
             file << (int64_t)i.nFeeDelta;
+            file << i.nFee;
+            file << i.nHeight;
+            file << i.fSpendsCoinbaseOrCoinstake;
+            file << i.nSigOps;
             mapDeltas.erase(i.tx->GetHash());
         }
 
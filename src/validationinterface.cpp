@@ -13,6 +13,7 @@
 #include "scheduler.h"
 #include "util/validation.h"
 #include "validation.h" // cs_main
+#include "validationtrace.h"
 
 #include <future>
 #include <list>
@@ -24,6 +25,7 @@ struct ValidationInterfaceConnections {
     boost::signals2::scoped_connection TransactionAddedToMempool;
     boost::signals2::scoped_connection BlockConnected;
     boost::signals2::scoped_connection BlockDisconnected;
+    boost::signals2::scoped_connection BlockValidationTraced;
     boost::signals2::scoped_connection TransactionRemovedFromMempool;
     boost::signals2::scoped_connection SetBestChain;
     boost::signals2::scoped_connection Broadcast;
@@ -44,6 +46,8 @@ struct MainSignalsInstance {
     boost::signals2::signal<void (const std::shared_ptr<const CBlock> &, const CBlockIndex *pindex)> BlockConnected;
     /** Notifies listeners of a block being disconnected */
     boost::signals2::signal<void (const std::shared_ptr<const CBlock> &, const uint256& blockHash, int nBlockHeight, int64_t blockTime)> BlockDisconnected;
+    /** Notifies listeners of the stage timings of a connected block */
+    boost::signals2::signal<void (const BlockValidationTrace&)> BlockValidationTraced;
     /** Notifies listeners of a transaction removal from the mempool */
     boost::signals2::signal<void (const CTransactionRef &, MemPoolRemovalReason reason)> TransactionRemovedFromMempool;
     /** Notifies listeners of a new active block chain. */
@@ -99,6 +103,7 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn)
     conns.TransactionAddedToMempool = g_signals.m_internals->TransactionAddedToMempool.connect(std::bind(&CValidationInterface::TransactionAddedToMempool, pwalletIn, std::placeholders::_1));
     conns.BlockConnected = g_signals.m_internals->BlockConnected.connect(std::bind(&CValidationInterface::BlockConnected, pwalletIn, std::placeholders::_1, std::placeholders::_2));
     conns.BlockDisconnected = g_signals.m_internals->BlockDisconnected.connect(std::bind(&CValidationInterface::BlockDisconnected, pwalletIn, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+    conns.BlockValidationTraced = g_signals.m_internals->BlockValidationTraced.connect(std::bind(&CValidationInterface::BlockValidationTraced, pwalletIn, std::placeholders::_1));
     conns.TransactionRemovedFromMempool = g_signals.m_internals->TransactionRemovedFromMempool.connect(std::bind(&CValidationInterface::TransactionRemovedFromMempool, pwalletIn, std::placeholders::_1, std::placeholders::_2));
     conns.SetBestChain = g_signals.m_internals->SetBestChain.connect(std::bind(&CValidationInterface::SetBestChain, pwalletIn, std::placeholders::_1));
     conns.Broadcast = g_signals.m_internals->Broadcast.connect(std::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, std::placeholders::_1));
@@ -199,6 +204,14 @@ void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock> &pblock
                           blockHash.ToString(), nBlockHeight, blockTime);
 }
 
+void CMainSignals::BlockValidationTraced(const BlockValidationTrace& trace) {
+    auto event = [trace, this] {
+        m_internals->BlockValidationTraced(trace);
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s, block height=%d", __func__,
+                          trace.hashBlock.ToString(), trace.nHeight);
+}
+
 void CMainSignals::SetBestChain(const CBlockLocator& locator) {
     auto event = [locator, this] {
         m_internals->SetBestChain(locator);
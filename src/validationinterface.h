@@ -24,6 +24,7 @@ class CValidationInterface;
 class CValidationState;
 class uint256;
 class CScheduler;
+struct BlockValidationTrace;
 enum class MemPoolRemovalReason;
 
 // These functions dispatch to one or all registered wallets
@@ -136,6 +137,12 @@ protected:
      * Called on a background thread.
      */
     virtual void BlockDisconnected(const std::shared_ptr<const CBlock> &block, const uint256& blockHash, int nBlockHeight, int64_t blockTime) {}
+    /**
+     * Notifies listeners of the stage timings of a connected block (when -blocktracesize is not 0)
+     *
+     * Called on a background thread.
+     */
+    virtual void BlockValidationTraced(const BlockValidationTrace& trace) {}
     /**
      * Notifies listeners of the new active block chain on-disk.
      *
@@ -177,6 +184,7 @@ public:
     void TransactionRemovedFromMempool(const CTransactionRef&, MemPoolRemovalReason);
     void BlockConnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex *pindex);
     void BlockDisconnected(const std::shared_ptr<const CBlock> &block, const uint256& blockHash, int nBlockHeight, int64_t blockTime);
+    void BlockValidationTraced(const BlockValidationTrace& trace);
     void SetBestChain(const CBlockLocator &);
     void Broadcast(CConnman* connman);
     void BlockChecked(const CBlock&, const CValidationState&);
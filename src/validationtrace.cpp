@@ -0,0 +1,122 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "validationtrace.h"
+
+#include <univalue.h>
+
+#include <algorithm>
+
+CBlockTraceBuffer g_blockTraces;
+
+UniValue BlockValidationTrace::ToJSON() const
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("hash", hashBlock.GetHex());
+    ret.pushKV("height", nHeight);
+    ret.pushKV("time", nTimeConnected);
+    ret.pushKV("size", (uint64_t)nSize);
+    ret.pushKV("tx", (uint64_t)nTx);
+    ret.pushKV("inputs", (uint64_t)nInputs);
+    ret.pushKV("outputs", (uint64_t)nOutputs);
+    ret.pushKV("shielded_spends", (uint64_t)nShieldedSpends);
+    ret.pushKV("shielded_outputs", (uint64_t)nShieldedOutputs);
+    ret.pushKV("special_tx", (uint64_t)nSpecialTx);
+
+    UniValue stages(UniValue::VOBJ);
+    stages.pushKV("check_block", nCheckBlock);
+    stages.pushKV("contextual_check", nContextualCheck);
+    stages.pushKV("sapling_proofs", nSaplingProofs);
+    stages.pushKV("read_block", nReadBlock);
+    stages.pushKV("prefetch_inputs", nPrefetchInputs);
+    stages.pushKV("connect_inputs", nConnectInputs);
+    stages.pushKV("verify_scripts", nVerifyScripts);
+    stages.pushKV("special_tx", nSpecialTxes);
+    stages.pushKV("index", nIndex);
+    stages.pushKV("flush", nFlush);
+    stages.pushKV("chainstate", nChainState);
+    stages.pushKV("post_connect", nPostConnect);
+    stages.pushKV("signals", nSignals);
+    stages.pushKV("total", nTotal);
+    ret.pushKV("stages_us", stages);
+    return ret;
+}
+
+void CBlockTraceBuffer::Resize(size_t nCapacityIn)
+{
+    LOCK(cs);
+    // Keep the most recent traces that still fit, oldest first
+    std::vector<BlockValidationTrace> vLatest;
+    if (!vTraces.empty()) {
+        for (size_t i = 0; i < vTraces.size(); i++) {
+            vLatest.push_back(std::move(vTraces[(nNext + i) % vTraces.size()]));
+        }
+        if (vLatest.size() > nCapacityIn) {
+            vLatest.erase(vLatest.begin(), vLatest.end() - nCapacityIn);
+        }
+    }
+    vTraces = std::move(vLatest);
+    nNext = vTraces.size() % std::max<size_t>(nCapacityIn, 1);
+    if (nCapacityIn == 0) {
+        mapPending.clear();
+        pendingOrder.clear();
+    }
+    nCapacity = nCapacityIn;
+}
+
+void CBlockTraceBuffer::AddPending(const uint256& hashBlock, int64_t nCheckBlock, int64_t nContextualCheck, int64_t nSaplingProofs)
+{
+    if (!IsEnabled()) return;
+    LOCK(cs);
+    auto it = mapPending.find(hashBlock);
+    if (it == mapPending.end()) {
+        if (pendingOrder.size() >= MAX_PENDING) {
+            // Blocks that never got connected (e.g. on a stale fork)
+            mapPending.erase(pendingOrder.front());
+            pendingOrder.pop_front();
+        }
+        it = mapPending.emplace(hashBlock, BlockValidationTrace()).first;
+        pendingOrder.push_back(hashBlock);
+    }
+    it->second.nCheckBlock += nCheckBlock;
+    it->second.nContextualCheck += nContextualCheck;
+    it->second.nSaplingProofs += nSaplingProofs;
+}
+
+void CBlockTraceBuffer::Push(BlockValidationTrace& trace)
+{
+    if (!IsEnabled()) return;
+    LOCK(cs);
+    const size_t nCap = nCapacity;
+    if (nCap == 0) return;
+    auto it = mapPending.find(trace.hashBlock);
+    if (it != mapPending.end()) {
+        trace.nCheckBlock += it->second.nCheckBlock;
+        trace.nContextualCheck += it->second.nContextualCheck;
+        trace.nSaplingProofs += it->second.nSaplingProofs;
+        mapPending.erase(it);
+        // The block may become pending again (reconsiderblock, reconnected after a
+        // reorg): a stale entry left here would later evict the new one early.
+        // Connected blocks are usually the oldest pending ones, near the front.
+        auto itOrder = std::find(pendingOrder.begin(), pendingOrder.end(), trace.hashBlock);
+        if (itOrder != pendingOrder.end()) pendingOrder.erase(itOrder);
+    }
+    if (vTraces.size() < nCap) {
+        vTraces.push_back(trace);
+    } else {
+        vTraces[nNext] = trace;
+    }
+    nNext = (nNext + 1) % nCap;
+}
+
+std::vector<BlockValidationTrace> CBlockTraceBuffer::GetLatest(size_t nCount) const
+{
+    LOCK(cs);
+    std::vector<BlockValidationTrace> ret;
+    const size_t nSize = vTraces.size();
+    for (size_t i = 1; i <= std::min(nCount, nSize); i++) {
+        ret.push_back(vTraces[(nNext + nSize - i) % nSize]);
+    }
+    return ret;
+}
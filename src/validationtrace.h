@@ -0,0 +1,94 @@
+// Copyright (c) 2021 The BCZ developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BCZ_VALIDATIONTRACE_H
+#define BCZ_VALIDATIONTRACE_H
+
+#include "sync.h"
+#include "uint256.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <vector>
+
+class UniValue;
+
+//! -blocktracesize default (number of blocks kept)
+static const unsigned int DEFAULT_BLOCK_TRACE_SIZE = 1000;
+
+/**
+ * Contents of one connected block and the time, in microseconds, spent in
+ * each validation stage. The checks done on acceptance (CheckBlock,
+ * ContextualCheckBlock and the Sapling proofs) are zero if the block was
+ * accepted before the node was restarted.
+ */
+struct BlockValidationTrace
+{
+    uint256 hashBlock;
+    int nHeight{0};
+    int64_t nTimeConnected{0};
+
+    unsigned int nSize{0};
+    unsigned int nTx{0};
+    unsigned int nInputs{0};
+    unsigned int nOutputs{0};
+    unsigned int nShieldedSpends{0};
+    unsigned int nShieldedOutputs{0};
+    unsigned int nSpecialTx{0};
+
+    int64_t nCheckBlock{0};         // CheckBlock, on acceptance and again on connection
+    int64_t nContextualCheck{0};    // ContextualCheckBlock, without the Sapling proofs
+    int64_t nSaplingProofs{0};      // Sapling proofs and signatures
+    int64_t nReadBlock{0};          // loading the block from disk
+    int64_t nPrefetchInputs{0};     // loading uncached inputs on the prefetch threads
+    int64_t nConnectInputs{0};      // coins lookups, CheckInputs, UpdateCoins
+    int64_t nVerifyScripts{0};      // waiting for the script check threads
+    int64_t nSpecialTxes{0};        // special txes: EvoDB, MN list, LLMQ commitments
+    int64_t nIndex{0};              // undo data and tx index writes
+    int64_t nFlush{0};              // coins view and EvoDB transaction flush
+    int64_t nChainState{0};         // FlushStateToDisk
+    int64_t nPostConnect{0};        // mempool and tip updates
+    int64_t nSignals{0};            // validation interface notifications
+    int64_t nTotal{0};              // all of the above from ConnectTip, without the acceptance checks
+
+    UniValue ToJSON() const;
+};
+
+/**
+ * Ring buffer of the traces of the most recently connected blocks.
+ * Acceptance happens well before connection during IBD, so the acceptance
+ * timings are held aside, keyed by block hash, until the block connects.
+ */
+class CBlockTraceBuffer
+{
+public:
+    /** Set the number of traces kept. 0 disables tracing and drops what was kept. */
+    void Resize(size_t nCapacityIn);
+    bool IsEnabled() const { return nCapacity > 0; }
+
+    /** Add acceptance check timings of a block that is not connected yet */
+    void AddPending(const uint256& hashBlock, int64_t nCheckBlock, int64_t nContextualCheck, int64_t nSaplingProofs);
+
+    /** Complete the trace with its pending acceptance timings, and store a copy */
+    void Push(BlockValidationTrace& trace);
+
+    /** The last nCount traces, most recent first */
+    std::vector<BlockValidationTrace> GetLatest(size_t nCount) const;
+
+private:
+    //! Blocks accepted ahead of the tip are at most the download window deep
+    static const size_t MAX_PENDING = 2048;
+
+    mutable Mutex cs;
+    std::atomic<size_t> nCapacity{0};
+    std::vector<BlockValidationTrace> vTraces GUARDED_BY(cs);
+    size_t nNext GUARDED_BY(cs){0};
+    std::map<uint256, BlockValidationTrace> mapPending GUARDED_BY(cs);
+    std::deque<uint256> pendingOrder GUARDED_BY(cs);
+};
+
+extern CBlockTraceBuffer g_blockTraces;
+
+#endif // BCZ_VALIDATIONTRACE_H
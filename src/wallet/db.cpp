@@ -443,7 +443,7 @@ void BerkeleyEnvironment::CheckpointLSN(const std::string& strFile)
 }
 
 
-BerkeleyBatch::BerkeleyBatch(BerkeleyDatabase& database, const char* pszMode, bool fFlushOnCloseIn) : pdb(nullptr), activeTxn(nullptr)
+BerkeleyBatch::BerkeleyBatch(BerkeleyDatabase& database, const char* pszMode, bool fFlushOnCloseIn) : pdb(nullptr), activeTxn(nullptr), m_database(database)
 {
     fReadOnly = (!strchr(pszMode, '+') && !strchr(pszMode, 'w'));
     fFlushOnClose = fFlushOnCloseIn;
@@ -540,6 +540,29 @@ void BerkeleyDatabase::IncrementUpdateCounter()
     ++nUpdateCounter;
 }
 
+void BerkeleyDatabase::BeginWriteGroup()
+{
+    ++nWriteGroups;
+}
+
+void BerkeleyDatabase::EndWriteGroup()
+{
+    if (--nWriteGroups == 0 && fSyncPending.exchange(false)) {
+        SyncWrites();
+    }
+}
+
+void BerkeleyDatabase::SyncWrites()
+{
+    if (IsDummy()) {
+        return;
+    }
+    LOCK(cs_db);
+    if (env->IsInitialized()) {
+        env->dbenv->txn_checkpoint(0, 0, 0);
+    }
+}
+
 void BerkeleyBatch::Close()
 {
     if (!pdb)
@@ -549,8 +572,14 @@ void BerkeleyBatch::Close()
     activeTxn = NULL;
     pdb = NULL;
 
-    if (fFlushOnClose)
-        Flush();
+    if (fFlushOnClose) {
+        if (!fReadOnly && m_database.nWriteGroups > 0) {
+            // Leave the checkpoint to the end of the write group
+            m_database.fSyncPending = true;
+        } else {
+            Flush();
+        }
+    }
 
     {
         LOCK(cs_db);
@@ -154,6 +154,17 @@ public:
 
     void IncrementUpdateCounter();
 
+    /**
+     * Group commit: while a write group is open, the batches closed do not
+     * checkpoint the environment one by one. A single checkpoint is made when
+     * the last group ends (or by the periodic flush, whichever comes first).
+     */
+    void BeginWriteGroup();
+    void EndWriteGroup();
+
+    /** Durability barrier: checkpoint the writes made so far, even inside a write group */
+    void SyncWrites();
+
     void ReloadDbEnv();
 
     std::atomic<unsigned int> nUpdateCounter;
@@ -167,6 +178,10 @@ private:
     BerkeleyEnvironment *env;
     std::string strFile;
 
+    std::atomic<int> nWriteGroups{0};
+    //! A batch skipped its checkpoint inside a write group
+    std::atomic<bool> fSyncPending{false};
+
     /** Return whether this database handle is a dummy for testing.
      * Only to be used at a low level, application should ideally not care
      * about this.
@@ -175,6 +190,20 @@ private:
 };
 
 
+/** RAII write group of a database, see BerkeleyDatabase::BeginWriteGroup */
+class BerkeleyWriteGroup
+{
+public:
+    explicit BerkeleyWriteGroup(BerkeleyDatabase& database) : m_database(database) { m_database.BeginWriteGroup(); }
+    ~BerkeleyWriteGroup() { m_database.EndWriteGroup(); }
+
+    BerkeleyWriteGroup(const BerkeleyWriteGroup&) = delete;
+    BerkeleyWriteGroup& operator=(const BerkeleyWriteGroup&) = delete;
+
+private:
+    BerkeleyDatabase& m_database;
+};
+
 /** RAII class that provides access to a Berkeley database */
 class BerkeleyBatch
 {
@@ -185,6 +214,7 @@ protected:
     bool fReadOnly;
     bool fFlushOnClose;
     BerkeleyEnvironment *env;
+    BerkeleyDatabase& m_database;
 
 public:
     explicit BerkeleyBatch(BerkeleyDatabase& database, const char* pszMode = "r+", bool fFlushOnCloseIn=true);
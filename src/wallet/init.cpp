@@ -205,6 +205,46 @@ bool WalletVerify()
     return true;
 }
 
+/** A wallet read by PreloadWallets, waiting for the chain to be loaded */
+struct PreloadedWallet
+{
+    std::string name;
+    std::unique_ptr<CWallet> pwallet;
+    bool fFirstRun{false};
+    //! The transactions were zapped (-zapwallettxes) when the database was read
+    bool fZapped{false};
+    //! Transactions zapped by -zapwallettxes, to restore their metadata
+    std::vector<CWalletTx> vWtx;
+};
+
+static std::vector<PreloadedWallet> vPreloadedWallets;
+
+bool PreloadWallets()
+{
+    if (gArgs.GetBoolArg("-disablewallet", DEFAULT_DISABLE_WALLET)) {
+        return true;
+    }
+
+    for (const std::string& walletFile : gArgs.GetArgs("-wallet")) {
+        PreloadedWallet preload;
+        preload.name = walletFile;
+        // Read the flag once: init can set it while the database is read
+        preload.fZapped = gArgs.GetBoolArg("-zapwallettxes", false);
+        preload.pwallet.reset(CWallet::LoadWalletFromFile(walletFile, fs::absolute(walletFile, GetWalletDir()),
+                                                          preload.fZapped, preload.fFirstRun, preload.vWtx));
+        if (!preload.pwallet) {
+            return false;
+        }
+        vPreloadedWallets.push_back(std::move(preload));
+    }
+    return true;
+}
+
+void UnloadPreloadedWallets()
+{
+    vPreloadedWallets.clear();
+}
+
 bool InitLoadWallet()
 {
     if (gArgs.GetBoolArg("-disablewallet", DEFAULT_DISABLE_WALLET)) {
@@ -212,16 +252,25 @@ bool InitLoadWallet()
         return true;
     }
 
-    for (const std::string& walletFile : gArgs.GetArgs("-wallet")) {
-        // create/load wallet
-        CWallet * const pwallet = CWallet::CreateWalletFromFile(walletFile, fs::absolute(walletFile, GetWalletDir()));
-        if (!pwallet) {
+    for (PreloadedWallet& preload : vPreloadedWallets) {
+        std::unique_ptr<CWallet> pwallet = std::move(preload.pwallet);
+        if (gArgs.GetBoolArg("-zapwallettxes", false) && !preload.fZapped) {
+            // The block database was rebuilt after the wallet was read, which zaps its transactions
+            pwallet.reset(CWallet::CreateWalletFromFile(preload.name, fs::absolute(preload.name, GetWalletDir())));
+            if (!pwallet) {
+                UnloadPreloadedWallets();
+                return false;
+            }
+        } else if (!pwallet->AttachChain(preload.fFirstRun, preload.vWtx)) {
+            UnloadPreloadedWallets();
             return false;
         }
 
         // add to wallets in use
-        vpwallets.emplace_back(pwallet);
+        uiInterface.LoadWallet(pwallet.get());
+        vpwallets.emplace_back(pwallet.release());
     }
+    vPreloadedWallets.clear();
 
     // automatic backup
     // do this after loading all wallets, so unique fileids are checked properly
@@ -20,7 +20,13 @@ bool WalletParameterInteraction();
 //  being loaded (CWallet::ParameterInteraction forbids -salvagewallet, -zapwallettxes or -upgradewallet with multiwallet).
 bool WalletVerify();
 
-//! Load wallet databases.
+//! Read the wallet databases, which does not need the chain: run while the block index loads.
+bool PreloadWallets();
+
+//! Free the wallets read by PreloadWallets and never loaded (startup aborted).
+void UnloadPreloadedWallets();
+
+//! Load the wallets read by PreloadWallets on top of the chain.
 bool InitLoadWallet();
 
 #endif // BCZ_WALLET_INIT_H
@@ -1056,6 +1056,15 @@ static void SendMoney(CWallet* const pwallet, const CTxDestination& address, CAm
 
 static SaplingOperation CreateShieldedTransaction(CWallet* const pwallet, const JSONRPCRequest& request);
 
+// The Sapling parameters are loaded in the background at startup: report their
+// loading state as a warm-up state rather than holding the RPC thread until they are ready.
+static void EnsureSaplingParamsLoaded()
+{
+    std::string strStatus;
+    if (!IsZKSNARKSReady(&strStatus))
+        throw JSONRPCError(RPC_IN_WARMUP, strStatus);
+}
+
 /*
  * redirect sendtoaddress/sendmany inputs to shieldsendmany implementation (CreateShieldedTransaction)
  */
@@ -1278,6 +1287,7 @@ static UniValue CreateColdStakeDelegation(CWallet* const pwallet, const UniValue
         if (sporkManager.IsSporkActive(SPORK_7_SAPLING_MAINTENANCE)) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "SHIELD in maintenance (SPORK 20)");
         }
+        EnsureSaplingParamsLoaded();
         std::vector<SendManyRecipient> recipients = {SendManyRecipient(ownerKey, *stakeKey, nValue)};
         SaplingOperation operation(consensus, pwallet);
         OperationResult res = operation.setSelectShieldedCoins(true)
@@ -1650,6 +1660,7 @@ UniValue viewshieldtransaction(const JSONRPCRequest& request)
 
 static SaplingOperation CreateShieldedTransaction(CWallet* const pwallet, const JSONRPCRequest& request)
 {
+    EnsureSaplingParamsLoaded();
     LOCK2(cs_main, pwallet->cs_wallet);
     SaplingOperation operation(Params().GetConsensus(), pwallet);
 
@@ -2089,17 +2100,20 @@ UniValue getreceivedbyaddress(const JSONRPCRequest& request)
     if (request.params.size() > 1)
         nMinDepth = request.params[1].get_int();
 
-    // Tally
+    // Tally the outputs received by the address
     CAmount nAmount = 0;
-    for (const auto& entry : pwallet->mapWallet) {
-        const CWalletTx& wtx = entry.second;
-        if (wtx.IsCoinBase() || !IsFinalTx(wtx.tx, nBlockHeight))
-            continue;
+    const std::set<COutPoint>* outputs = pwallet->GetOutputsByDestination(address);
+    if (outputs) {
+        for (const COutPoint& out : *outputs) {
+            const CWalletTx* wtx = pwallet->GetWalletTx(out.hash);
+            if (!wtx || wtx->IsCoinBase() || !IsFinalTx(wtx->tx, nBlockHeight))
+                continue;
 
-        for (const CTxOut& txout : wtx.tx->vout)
+            const CTxOut& txout = wtx->tx->vout[out.n];
             if (txout.scriptPubKey == scriptPubKey)
-                if (wtx.GetDepthInMainChain() >= nMinDepth)
+                if (wtx->GetDepthInMainChain() >= nMinDepth)
                     nAmount += txout.nValue;
+        }
     }
 
     return ValueFromAmount(nAmount);
@@ -2562,42 +2576,40 @@ static UniValue ListReceived(CWallet* const pwallet, const UniValue& params, boo
         has_filtered_address = true;
     }
 
-    // Tally
+    // Tally the outputs received by each address (or by the filtered one)
     std::map<CTxDestination, tallyitem> mapTally;
-    for (const auto& entry : pwallet->mapWallet) {
-        const CWalletTx& wtx = entry.second;
-
-        if (!IsFinalTx(wtx.tx, nBlockHeight)) {
-            continue;
-        }
-
-        int nDepth = wtx.GetDepthInMainChain();
-        if (nDepth < nMinDepth) {
-            continue;
+    auto tallyAddress = [&](const CTxDestination& address, const std::set<COutPoint>& outputs) {
+        isminefilter mine = IsMine(*pwallet, address);
+        if (!(mine & filter)) {
+            return;
         }
 
-        for (const CTxOut& txout : wtx.tx->vout) {
-            CTxDestination address;
-            if (!ExtractDestination(txout.scriptPubKey, address)) {
-                continue;
-            }
-
-            if (has_filtered_address && !(filtered_address == address)) {
+        for (const COutPoint& out : outputs) {
+            const CWalletTx* wtx = pwallet->GetWalletTx(out.hash);
+            if (!wtx || !IsFinalTx(wtx->tx, nBlockHeight)) {
                 continue;
             }
 
-            isminefilter mine = IsMine(*pwallet, address);
-            if (!(mine & filter)) {
+            int nDepth = wtx->GetDepthInMainChain();
+            if (nDepth < nMinDepth) {
                 continue;
             }
 
             tallyitem& item = mapTally[address];
-            item.nAmount += txout.nValue;
+            item.nAmount += wtx->tx->vout[out.n].nValue;
             item.nConf = std::min(item.nConf, nDepth);
-            item.txids.push_back(wtx.GetHash());
+            item.txids.push_back(out.hash);
             if (mine & ISMINE_WATCH_ONLY)
                 item.fIsWatchonly = true;
         }
+    };
+    if (has_filtered_address) {
+        const std::set<COutPoint>* outputs = pwallet->GetOutputsByDestination(filtered_address);
+        if (outputs) tallyAddress(filtered_address, *outputs);
+    } else {
+        for (const auto& it : pwallet->GetOutputsByDestination()) {
+            tallyAddress(it.first, it.second);
+        }
     }
 
     // Create mapAddressBook iterator
@@ -2912,39 +2924,39 @@ UniValue listcoldutxos(const JSONRPCRequest& request)
         fExcludeWhitelisted = request.params[0].get_bool();
     UniValue results(UniValue::VARR);
 
-    for (const auto& entry : pwallet->mapWallet) {
-        const uint256& wtxid = entry.first;
-        const CWalletTx* pcoin = &entry.second;
-        if (!CheckFinalTx(pcoin->tx) || !pcoin->IsTrusted())
+    // Only visit the P2CS outputs of the wallet transactions
+    for (const COutPoint& outpoint : pwallet->GetP2CSOutputs()) {
+        const uint256& wtxid = outpoint.hash;
+        const CWalletTx* pcoin = pwallet->GetWalletTx(wtxid);
+        if (!pcoin || !CheckFinalTx(pcoin->tx) || !pcoin->IsTrusted())
             continue;
 
         // if this tx has no unspent P2CS outputs for us, skip it
         if(pcoin->GetColdStakingCredit() == 0 && pcoin->GetStakeDelegationCredit() == 0)
             continue;
 
-        for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
-            const CTxOut& out = pcoin->tx->vout[i];
-            isminetype mine = pwallet->IsMine(out);
-            if (!bool(mine & ISMINE_COLD) && !bool(mine & ISMINE_SPENDABLE_DELEGATED))
-                continue;
-            txnouttype type;
-            std::vector<CTxDestination> addresses;
-            int nRequired;
-            if (!ExtractDestinations(out.scriptPubKey, type, addresses, nRequired))
-                continue;
-            const bool fWhitelisted = pwallet->HasAddressBook(addresses[1]) > 0;
-            if (fExcludeWhitelisted && fWhitelisted)
-                continue;
-            UniValue entry(UniValue::VOBJ);
-            entry.pushKV("txid", wtxid.GetHex());
-            entry.pushKV("txidn", (int)i);
-            entry.pushKV("amount", ValueFromAmount(out.nValue));
-            entry.pushKV("confirmations", pcoin->GetDepthInMainChain());
-            entry.pushKV("cold-staker", EncodeDestination(addresses[0], CChainParams::STAKING_ADDRESS));
-            entry.pushKV("coin-owner", EncodeDestination(addresses[1]));
-            entry.pushKV("whitelisted", fWhitelisted ? "true" : "false");
-            results.push_back(entry);
-        }
+        const unsigned int i = outpoint.n;
+        const CTxOut& out = pcoin->tx->vout[i];
+        isminetype mine = pwallet->IsMine(out);
+        if (!bool(mine & ISMINE_COLD) && !bool(mine & ISMINE_SPENDABLE_DELEGATED))
+            continue;
+        txnouttype type;
+        std::vector<CTxDestination> addresses;
+        int nRequired;
+        if (!ExtractDestinations(out.scriptPubKey, type, addresses, nRequired))
+            continue;
+        const bool fWhitelisted = pwallet->HasAddressBook(addresses[1]) > 0;
+        if (fExcludeWhitelisted && fWhitelisted)
+            continue;
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("txid", wtxid.GetHex());
+        entry.pushKV("txidn", (int)i);
+        entry.pushKV("amount", ValueFromAmount(out.nValue));
+        entry.pushKV("confirmations", pcoin->GetDepthInMainChain());
+        entry.pushKV("cold-staker", EncodeDestination(addresses[0], CChainParams::STAKING_ADDRESS));
+        entry.pushKV("coin-owner", EncodeDestination(addresses[1]));
+        entry.pushKV("whitelisted", fWhitelisted ? "true" : "false");
+        results.push_back(entry);
     }
 
     return results;
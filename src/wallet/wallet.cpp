@@ -758,6 +758,59 @@ void CWallet::AddToSpends(const uint256& wtxid)
     }
 }
 
+void CWallet::AddToDestIndex(const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    const uint256& wtxid = wtx.GetHash();
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+        const CScript& script = wtx.tx->vout[i].scriptPubKey;
+        CTxDestination dest;
+        if (ExtractDestination(script, dest)) {
+            mapOutputsByDest[dest].emplace(wtxid, i);
+        }
+        if (script.IsPayToColdStaking()) {
+            setP2CSOutputs.emplace(wtxid, i);
+        }
+    }
+}
+
+void CWallet::RemoveFromDestIndex(const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    const uint256& wtxid = wtx.GetHash();
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+        const COutPoint out(wtxid, i);
+        CTxDestination dest;
+        if (ExtractDestination(wtx.tx->vout[i].scriptPubKey, dest)) {
+            auto it = mapOutputsByDest.find(dest);
+            if (it != mapOutputsByDest.end()) {
+                it->second.erase(out);
+                if (it->second.empty()) mapOutputsByDest.erase(it);
+            }
+        }
+        setP2CSOutputs.erase(out);
+    }
+}
+
+const std::set<COutPoint>* CWallet::GetOutputsByDestination(const CTxDestination& dest) const
+{
+    AssertLockHeld(cs_wallet);
+    auto it = mapOutputsByDest.find(dest);
+    return it == mapOutputsByDest.end() ? nullptr : &it->second;
+}
+
+const std::map<CTxDestination, std::set<COutPoint>>& CWallet::GetOutputsByDestination() const
+{
+    AssertLockHeld(cs_wallet);
+    return mapOutputsByDest;
+}
+
+const std::set<COutPoint>& CWallet::GetP2CSOutputs() const
+{
+    AssertLockHeld(cs_wallet);
+    return setP2CSOutputs;
+}
+
 bool CWallet::EncryptWallet(const SecureString& strWalletPassphrase)
 {
     if (IsCrypted())
@@ -905,6 +958,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
         wtxOrdered.emplace(wtx.nOrderPos, &wtx);
         wtx.UpdateTimeSmart();
         AddToSpends(hash);
+        AddToDestIndex(wtx);
     }
 
     bool fUpdated = false;
@@ -929,6 +983,9 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
             fUpdated = true;
         }
     }
+    if (HasSaplingSPKM()) {
+        m_sspk_man->UpdateAddressNoteMapWithTx(wtx);
+    }
 
     //// debug print
     LogPrintf("AddToWallet %s  %s%s\n", wtxIn.GetHash().ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""));
@@ -970,45 +1027,58 @@ static Optional<int> getTipBlockHeight(const uint256& hash) EXCLUSIVE_LOCKS_REQU
 
 bool CWallet::LoadToWallet(CWalletTx& wtxIn)
 {
-    LOCK2(cs_main, cs_wallet);
-    // If tx hasn't been reorged out of chain while wallet being shutdown
-    // change tx status to UNCONFIRMED and reset hashBlock/nIndex.
-    if (!wtxIn.m_confirm.hashBlock.IsNull()) {
-        Optional<int> block_height = getTipBlockHeight(wtxIn.m_confirm.hashBlock);
+    // The chain may still be loading: the transaction blocks are resolved by LoadTxsChainState
+    LOCK(cs_wallet);
+    const uint256& hash = wtxIn.GetHash();
+    CWalletTx& wtx = mapWallet.emplace(hash, wtxIn).first->second;
+    wtx.BindWallet(this);
+    // Sapling
+    m_sspk_man->UpdateNullifierNoteMapWithTx(wtx);
+    m_sspk_man->UpdateAddressNoteMapWithTx(wtx);
+    wtxOrdered.emplace(wtx.nOrderPos, &wtx);
+    AddToSpends(hash);
+    AddToDestIndex(wtx);
+    return true;
+}
+
+void CWallet::LoadTxsChainState()
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+    for (auto& it : mapWallet) {
+        CWalletTx& wtx = it.second;
+        // If tx hasn't been reorged out of chain while wallet being shutdown
+        // change tx status to UNCONFIRMED and reset hashBlock/nIndex.
+        if (wtx.m_confirm.hashBlock.IsNull()) continue;
+        Optional<int> block_height = getTipBlockHeight(wtx.m_confirm.hashBlock);
         if (block_height) {
             // Update cached block height variable since it not stored in the
             // serialized transaction.
-            wtxIn.m_confirm.block_height = *block_height;
-        } else if (wtxIn.isConflicted() || wtxIn.isConfirmed()) {
+            wtx.m_confirm.block_height = *block_height;
+        } else if (wtx.isConflicted() || wtx.isConfirmed()) {
             // If tx block (or conflicting block) was reorged out of chain
             // while the wallet was shutdown, change tx status to UNCONFIRMED
             // and reset block height, hash, and index. ABANDONED tx don't have
             // associated blocks and don't need to be updated. The case where a
             // transaction was reorged out while online and then reconfirmed
             // while offline is covered by the rescan logic.
-            wtxIn.setUnconfirmed();
-            wtxIn.m_confirm.hashBlock = UINT256_ZERO;
-            wtxIn.m_confirm.block_height = 0;
-            wtxIn.m_confirm.nIndex = 0;
+            wtx.setUnconfirmed();
+            wtx.m_confirm.hashBlock = UINT256_ZERO;
+            wtx.m_confirm.block_height = 0;
+            wtx.m_confirm.nIndex = 0;
         }
     }
-    const uint256& hash = wtxIn.GetHash();
-    CWalletTx& wtx = mapWallet.emplace(hash, wtxIn).first->second;
-    wtx.BindWallet(this);
-    // Sapling
-    m_sspk_man->UpdateNullifierNoteMapWithTx(wtx);
-    wtxOrdered.emplace(wtx.nOrderPos, &wtx);
-    AddToSpends(hash);
-    for (const CTxIn& txin : wtx.tx->vin) {
-        auto it = mapWallet.find(txin.prevout.hash);
-        if (it != mapWallet.end()) {
-            CWalletTx& prevtx = it->second;
-            if (prevtx.isConflicted()) {
-                MarkConflicted(prevtx.m_confirm.hashBlock, prevtx.m_confirm.block_height, wtx.GetHash());
+    for (auto& it : mapWallet) {
+        for (const CTxIn& txin : it.second.tx->vin) {
+            auto mi = mapWallet.find(txin.prevout.hash);
+            if (mi != mapWallet.end()) {
+                CWalletTx& prevtx = mi->second;
+                if (prevtx.isConflicted()) {
+                    MarkConflicted(prevtx.m_confirm.hashBlock, prevtx.m_confirm.block_height, it.first);
+                }
             }
         }
     }
-    return true;
 }
 
 bool CWallet::FindNotesDataAndAddMissingIVKToKeystore(const CTransaction& tx, Optional<mapSaplingNoteData_t>& saplingNoteData)
@@ -1308,6 +1378,8 @@ void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const
 {
     {
         LOCK(cs_wallet);
+        // One checkpoint for all the writes of the block (txs, keypool top-ups, witnesses)
+        WalletWriteGroup writeGroup(*database);
 
         m_last_block_processed = pindex->GetBlockHash();
         m_last_block_processed_time = pindex->GetBlockTime();
@@ -1341,6 +1413,7 @@ void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const
 void CWallet::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const uint256& blockHash, int nBlockHeight, int64_t blockTime)
 {
     LOCK(cs_wallet);
+    WalletWriteGroup writeGroup(*database);
 
     // At block disconnection, this will change an abandoned transaction to
     // be unconfirmed, whether or not the transaction is added back to the mempool.
@@ -1417,8 +1490,12 @@ void CWallet::EraseFromWallet(const uint256& hash)
 {
     {
         LOCK(cs_wallet);
-        if (mapWallet.erase(hash))
+        auto it = mapWallet.find(hash);
+        if (it != mapWallet.end()) {
+            RemoveFromDestIndex(it->second);
+            mapWallet.erase(it);
             WalletBatch(*database).EraseTx(hash);
+        }
         LogPrintf("%s: Erased wtx %s from wallet\n", __func__, hash.GetHex());
     }
     return;
@@ -1864,6 +1941,8 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
     CBlockIndex* pindex = pindexStart;
     CBlockIndex* ret = nullptr;
     {
+        // Checkpoint the wallet once at the end of the scan, not for each transaction found
+        WalletWriteGroup writeGroup(*database);
         ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
         CBlockIndex* tip = nullptr;
         double dProgressStart;
@@ -2495,8 +2574,79 @@ bool CWallet::AvailableCoins(std::vector<COutput>* pCoins,      // --> populates
     {
         LOCK(cs_wallet);
         CAmount nTotal = 0;
+
+        // Returns true once the search is over
+        auto checkOutput = [&](const CWalletTx* pcoin, unsigned int i, int nDepth, bool safeTx) {
+            const auto& output = pcoin->tx->vout[i];
+
+            // Filter by value if needed
+            if (coinsFilter.nMaxOutValue > 0 && output.nValue > coinsFilter.nMaxOutValue) {
+                return false;
+            }
+            if (coinsFilter.nMinOutValue > 0 && output.nValue < coinsFilter.nMinOutValue) {
+                return false;
+            }
+
+            // Now check for chain availability
+            auto res = CheckOutputAvailability(
+                    output,
+                    i,
+                    pcoin->GetHash(),
+                    coinControl,
+                    fCoinsSelected,
+                    coinsFilter.fIncludeColdStaking,
+                    coinsFilter.fIncludeDelegated,
+                    coinsFilter.fIncludeLocked);
+
+            if (!res.available) return false;
+            if (coinsFilter.fOnlySpendable && !res.spendable) return false;
+
+            // found valid coin
+            if (!pCoins) return true;
+            pCoins->emplace_back(pcoin, (int) i, nDepth, res.spendable, res.solvable, safeTx);
+
+            // Checks the sum amount of all UTXO's.
+            if (coinsFilter.nMinimumSumAmount != 0) {
+                nTotal += output.nValue;
+
+                if (nTotal >= coinsFilter.nMinimumSumAmount) {
+                    return true;
+                }
+            }
+
+            // Checks the maximum number of UTXO's.
+            return coinsFilter.nMaximumCount > 0 && pCoins->size() >= coinsFilter.nMaximumCount;
+        };
+
+        // Filter by specific destinations if needed: only visit the outputs they received
+        if (coinsFilter.onlyFilteredDest && !coinsFilter.onlyFilteredDest->empty()) {
+            std::set<COutPoint> setOutputs;
+            for (const CTxDestination& dest : *coinsFilter.onlyFilteredDest) {
+                const std::set<COutPoint>* outputs = GetOutputsByDestination(dest);
+                if (outputs) setOutputs.insert(outputs->begin(), outputs->end());
+            }
+
+            // Outputs are sorted by txid, as mapWallet, check each tx once
+            const CWalletTx* pcoin = nullptr;
+            bool fTxAvailable = false;
+            int nDepth = 0;
+            bool safeTx = false;
+            for (const COutPoint& out : setOutputs) {
+                if (!pcoin || pcoin->GetHash() != out.hash) {
+                    auto it = mapWallet.find(out.hash);
+                    if (it == mapWallet.end()) continue;
+                    pcoin = &it->second;
+                    nDepth = 0;
+                    safeTx = false;
+                    fTxAvailable = CheckTXAvailability(pcoin, coinsFilter.fOnlySafe, nDepth, safeTx, m_last_block_processed_height) &&
+                                   nDepth >= coinsFilter.minDepth;
+                }
+                if (fTxAvailable && checkOutput(pcoin, out.n, nDepth, safeTx)) return true;
+            }
+            return (pCoins && !pCoins->empty());
+        }
+
         for (const auto& entry : mapWallet) {
-            const uint256& wtxid = entry.first;
             const CWalletTx* pcoin = &entry.second;
 
             // Check if the tx is selectable
@@ -2509,55 +2659,7 @@ bool CWallet::AvailableCoins(std::vector<COutput>* pCoins,      // --> populates
             if (nDepth < coinsFilter.minDepth) continue;
 
             for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
-                const auto& output = pcoin->tx->vout[i];
-
-                // Filter by value if needed
-                if (coinsFilter.nMaxOutValue > 0 && output.nValue > coinsFilter.nMaxOutValue) {
-                    continue;
-                }
-                if (coinsFilter.nMinOutValue > 0 && output.nValue < coinsFilter.nMinOutValue) {
-                    continue;
-                }
-
-                // Filter by specific destinations if needed
-                if (coinsFilter.onlyFilteredDest && !coinsFilter.onlyFilteredDest->empty()) {
-                    CTxDestination address;
-                    if (!ExtractDestination(output.scriptPubKey, address) || !coinsFilter.onlyFilteredDest->count(address)) {
-                        continue;
-                    }
-                }
-
-                // Now check for chain availability
-                auto res = CheckOutputAvailability(
-                        output,
-                        i,
-                        wtxid,
-                        coinControl,
-                        fCoinsSelected,
-                        coinsFilter.fIncludeColdStaking,
-                        coinsFilter.fIncludeDelegated,
-                        coinsFilter.fIncludeLocked);
-
-                if (!res.available) continue;
-                if (coinsFilter.fOnlySpendable && !res.spendable) continue;
-
-                // found valid coin
-                if (!pCoins) return true;
-                pCoins->emplace_back(pcoin, (int) i, nDepth, res.spendable, res.solvable, safeTx);
-
-                // Checks the sum amount of all UTXO's.
-                if (coinsFilter.nMinimumSumAmount != 0) {
-                    nTotal += output.nValue;
-
-                    if (nTotal >= coinsFilter.nMinimumSumAmount) {
-                        return true;
-                    }
-                }
-
-                // Checks the maximum number of UTXO's.
-                if (coinsFilter.nMaximumCount > 0 && pCoins->size() >= coinsFilter.nMaximumCount) {
-                    return true;
-                }
+                if (checkOutput(pcoin, i, nDepth, safeTx)) return true;
             }
         }
         return (pCoins && !pCoins->empty());
@@ -2566,31 +2668,40 @@ bool CWallet::AvailableCoins(std::vector<COutput>* pCoins,      // --> populates
 
 std::map<CTxDestination , std::vector<COutput> > CWallet::AvailableCoinsByAddress(bool fOnlySafe, CAmount maxCoinValue, bool fIncludeColdStaking)
 {
-    CWallet::AvailableCoinsFilter coinFilter;
-    coinFilter.fIncludeColdStaking = true;
-    coinFilter.fOnlySafe = fOnlySafe;
-    coinFilter.fIncludeColdStaking = fIncludeColdStaking;
-    coinFilter.nMaxOutValue = maxCoinValue;
-    std::vector<COutput> vCoins;
-    AvailableCoins(&vCoins, nullptr, coinFilter);
-
+    // Walk the outputs by destination: P2CS are grouped by owner, as ExtractDestination does
     std::map<CTxDestination, std::vector<COutput> > mapCoins;
-    for (const COutput& out : vCoins) {
-        CTxDestination address;
-        bool fColdStakeAddr = false;
-        if (!ExtractDestination(out.tx->tx->vout[out.i].scriptPubKey, address, fColdStakeAddr)) {
-            bool isP2CS = out.tx->tx->vout[out.i].scriptPubKey.IsPayToColdStaking();
-            if (isP2CS && !fIncludeColdStaking) {
-                // It must never happen as the coin filtering process shouldn't had added the P2CS in the first place
-                assert(false);
+    LOCK(cs_wallet);
+    // Availability of each tx visited, outputs of a tx can go to several destinations
+    std::map<uint256, Optional<std::pair<int, bool>>> mapTxAvailable;
+    for (const auto& it : mapOutputsByDest) {
+        for (const COutPoint& out : it.second) {
+            auto itTx = mapWallet.find(out.hash);
+            if (itTx == mapWallet.end()) continue;
+            const CWalletTx* pcoin = &itTx->second;
+            const CTxOut& output = pcoin->tx->vout[out.n];
+
+            // Filter by value first, it does not need the tx checks
+            if (maxCoinValue > 0 && output.nValue > maxCoinValue) continue;
+
+            auto itAvailable = mapTxAvailable.find(out.hash);
+            if (itAvailable == mapTxAvailable.end()) {
+                int nDepth = 0;
+                bool safeTx = false;
+                Optional<std::pair<int, bool>> available;
+                if (CheckTXAvailability(pcoin, fOnlySafe, nDepth, safeTx, m_last_block_processed_height)) {
+                    available = std::make_pair(nDepth, safeTx);
+                }
+                itAvailable = mapTxAvailable.emplace(out.hash, available).first;
             }
-            // if this is a P2CS we don't have the owner key - check if we have the staking key
-            fColdStakeAddr = true;
-            if (!isP2CS || !ExtractDestination(out.tx->tx->vout[out.i].scriptPubKey, address, fColdStakeAddr) )
-                continue;
-        }
+            if (!itAvailable->second) continue;
 
-        mapCoins[address].emplace_back(out);
+            auto res = CheckOutputAvailability(output, out.n, out.hash, nullptr, false,
+                                               fIncludeColdStaking, true /* fIncludeDelegated */, false /* fIncludeLocked */);
+            if (!res.available) continue;
+
+            mapCoins[it.first].emplace_back(pcoin, (int) out.n, itAvailable->second->first,
+                                            res.spendable, res.solvable, itAvailable->second->second);
+        }
     }
 
     return mapCoins;
@@ -3170,6 +3281,7 @@ bool CWallet::CreateTransaction(const std::vector<CRecipient>& vecSend,
 
         if (sign) {
             CTransaction txNewConst(txNew);
+            const PrecomputedTransactionData txdata(txNewConst);
             int nIn = 0;
             for (const auto& coin : setCoins) {
                 const CScript& scriptPubKey = coin.first->tx->vout[coin.second].scriptPubKey;
@@ -3177,7 +3289,7 @@ bool CWallet::CreateTransaction(const std::vector<CRecipient>& vecSend,
                 bool haveKey = coin.first->GetStakeDelegationCredit() > 0;
 
                 if (!ProduceSignature(
-                        TransactionSignatureCreator(this, &txNewConst, nIn, coin.first->tx->vout[coin.second].nValue, SIGHASH_ALL),
+                        TransactionSignatureCreator(this, &txNewConst, nIn, coin.first->tx->vout[coin.second].nValue, SIGHASH_ALL, txdata),
                         scriptPubKey,
                         sigdata,
                         txNewConst.GetRequiredSigVersion(),
@@ -3442,7 +3554,10 @@ CWallet::CommitResult CWallet::CommitTransaction(CTransactionRef tx, CReserveKey
 
             // Add tx to wallet, because if it has change it's also ours,
             // otherwise just for transaction history.
-            AddToWallet(wtxNew);
+            AddToWallet(wtxNew, false);
+            // Durability barrier: the spend must be on disk before it is relayed,
+            // even while a write group (e.g. a rescan) defers the checkpoints
+            database->SyncWrites();
 
             // Notify that old coins are spent
             {
@@ -3490,7 +3605,8 @@ CWallet::CommitResult CWallet::CommitTransaction(CTransactionRef tx, CReserveKey
 
 DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
 {
-    LOCK2(cs_main, cs_wallet);
+    // Does not need the chain, so that it can be read while the block index loads
+    LOCK(cs_wallet);
 
     DBErrors nLoadWalletRet = WalletBatch(*database, "cr+").LoadWallet(this);
     if (nLoadWalletRet == DB_NEED_REWRITE) {
@@ -3506,12 +3622,7 @@ DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
     // This wallet is in its first run if all of these are empty
     fFirstRunRet = mapKeys.empty() && mapCryptedKeys.empty() && mapMasterKeys.empty() && setWatchOnly.empty() && mapScripts.empty();
 
-    if (nLoadWalletRet != DB_LOAD_OK)
-        return nLoadWalletRet;
-
-    uiInterface.LoadWallet(this);
-
-    return DB_LOAD_OK;
+    return nLoadWalletRet;
 }
 
 
@@ -4120,14 +4231,11 @@ void CWallet::LockIfMyCollateral(const CTransactionRef& ptx)
     }
 }
 
-CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path& path)
+CWallet* CWallet::LoadWalletFromFile(const std::string& name, const fs::path& path, bool fZap, bool& fFirstRun, std::vector<CWalletTx>& vWtx)
 {
     const std::string& walletFile = name;
 
-    // needed to restore wallet transaction meta data after -zapwallettxes
-    std::vector<CWalletTx> vWtx;
-
-    if (gArgs.GetBoolArg("-zapwallettxes", false)) {
+    if (fZap) {
         uiInterface.InitMessage(_("Zapping all transactions from wallet..."));
 
         std::unique_ptr<CWallet> tempWallet = std::make_unique<CWallet>(name, WalletDatabase::Create(path));
@@ -4141,7 +4249,7 @@ CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path&
     uiInterface.InitMessage(_("Loading wallet..."));
 
     int64_t nStart = GetTimeMillis();
-    bool fFirstRun = true;
+    fFirstRun = true;
     CWallet *walletInstance = new CWallet(name, WalletDatabase::Create(path));
     DBErrors nLoadWalletRet = walletInstance->LoadWallet(fFirstRun);
     if (nLoadWalletRet != DB_LOAD_OK) {
@@ -4232,35 +4340,46 @@ CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path&
             UIError(_("Unable to generate initial key!"));
             return nullptr;
         }
-
-        walletInstance->SetBestChain(WITH_LOCK(cs_main, return chainActive.GetLocator()));
     }
 
     LogPrintf("Wallet completed loading in %15dms\n", GetTimeMillis() - nStart);
+    return walletInstance;
+}
 
+bool CWallet::AttachChain(bool fFirstRun, const std::vector<CWalletTx>& vWtx)
+{
     LOCK(cs_main);
+    {
+        LOCK(cs_wallet);
+        LoadTxsChainState();
+    }
+
+    if (fFirstRun) {
+        SetBestChain(chainActive.GetLocator());
+    }
+
     CBlockIndex* pindexRescan = chainActive.Genesis();
 
     if (gArgs.GetBoolArg("-rescan", false)) {
         // clear note witness cache before a full rescan
-        walletInstance->ClearNoteWitnessCache();
+        ClearNoteWitnessCache();
     } else {
-        WalletBatch batch(*walletInstance->database);
+        WalletBatch batch(*database);
         CBlockLocator locator;
         if (batch.ReadBestBlock(locator))
             pindexRescan = FindForkInGlobalIndex(chainActive, locator);
     }
 
     {
-        LOCK(walletInstance->cs_wallet);
+        LOCK(cs_wallet);
         const CBlockIndex* tip = chainActive.Tip();
         if (tip) {
-            walletInstance->m_last_block_processed = tip->GetBlockHash();
-            walletInstance->m_last_block_processed_height = tip->nHeight;
-            walletInstance->m_last_block_processed_time = tip->GetBlockTime();
+            m_last_block_processed = tip->GetBlockHash();
+            m_last_block_processed_height = tip->nHeight;
+            m_last_block_processed_time = tip->GetBlockTime();
         }
     }
-    RegisterValidationInterface(walletInstance);
+    RegisterValidationInterface(this);
 
     if (chainActive.Tip() && chainActive.Tip() != pindexRescan) {
         uiInterface.InitMessage(_("Rescanning..."));
@@ -4268,33 +4387,33 @@ CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path&
 
         // no need to read and scan block, if block was created before
         // our wallet birthday (as adjusted for block time variability)
-        while (pindexRescan && walletInstance->nTimeFirstKey &&
-                pindexRescan->GetBlockTime() < (walletInstance->nTimeFirstKey - TIMESTAMP_WINDOW)) {
+        while (pindexRescan && nTimeFirstKey &&
+                pindexRescan->GetBlockTime() < (nTimeFirstKey - TIMESTAMP_WINDOW)) {
             pindexRescan = chainActive.Next(pindexRescan);
         }
         const int64_t nWalletRescanTime = GetTimeMillis();
         {
-            WalletRescanReserver reserver(walletInstance);
+            WalletRescanReserver reserver(this);
             if (!reserver.reserve()) {
                 UIError(_("Failed to rescan the wallet during initialization"));
-                return nullptr;
+                return false;
             }
-            if (walletInstance->ScanForWalletTransactions(pindexRescan, nullptr, reserver, true, true) != nullptr) {
+            if (ScanForWalletTransactions(pindexRescan, nullptr, reserver, true, true) != nullptr) {
                 UIError(_("Shutdown requested over the txs scan. Exiting."));
-                return nullptr;
+                return false;
             }
         }
         LogPrintf("Rescan completed in %15dms\n", GetTimeMillis() - nWalletRescanTime);
-        walletInstance->SetBestChain(chainActive.GetLocator());
-        walletInstance->database->IncrementUpdateCounter();
+        SetBestChain(chainActive.GetLocator());
+        database->IncrementUpdateCounter();
 
         // Restore wallet transaction metadata after -zapwallettxes=1
         if (gArgs.GetBoolArg("-zapwallettxes", false) && gArgs.GetArg("-zapwallettxes", "1") != "2") {
-            WalletBatch batch(*walletInstance->database);
+            WalletBatch batch(*database);
             for (const CWalletTx& wtxOld : vWtx) {
                 uint256 hash = wtxOld.GetHash();
-                std::map<uint256, CWalletTx>::iterator mi = walletInstance->mapWallet.find(hash);
-                if (mi != walletInstance->mapWallet.end()) {
+                std::map<uint256, CWalletTx>::iterator mi = mapWallet.find(hash);
+                if (mi != mapWallet.end()) {
                     const CWalletTx* copyFrom = &wtxOld;
                     CWalletTx* copyTo = &mi->second;
                     copyTo->mapValue = copyFrom->mapValue;
@@ -4309,7 +4428,19 @@ CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path&
         }
     }
 
-    return walletInstance;
+    return true;
+}
+
+CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path& path)
+{
+    // needed to restore wallet transaction meta data after -zapwallettxes
+    std::vector<CWalletTx> vWtx;
+    bool fFirstRun;
+    std::unique_ptr<CWallet> walletInstance(LoadWalletFromFile(name, path, gArgs.GetBoolArg("-zapwallettxes", false), fFirstRun, vWtx));
+    if (!walletInstance || !walletInstance->AttachChain(fFirstRun, vWtx)) {
+        return nullptr;
+    }
+    return walletInstance.release();
 }
 
 
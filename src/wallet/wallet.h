@@ -639,6 +639,18 @@ private:
     void AddToSpends(const COutPoint& outpoint, const uint256& wtxid);
     void AddToSpends(const uint256& wtxid);
 
+    /**
+     * Outputs of the wallet transactions by destination (P2CS by owner), so
+     * that the per-address queries do not walk the whole mapWallet. Only the
+     * outpoints are kept: depth and spent state are read from the transactions
+     * when queried, as they change with every block, conflict and abandon.
+     */
+    std::map<CTxDestination, std::set<COutPoint>> mapOutputsByDest;
+    //! P2CS outputs of the wallet transactions
+    std::set<COutPoint> setP2CSOutputs;
+    void AddToDestIndex(const CWalletTx& wtx);
+    void RemoveFromDestIndex(const CWalletTx& wtx);
+
     /* Mark a transaction (and its in-wallet descendants) as conflicting with a particular block. */
     void MarkConflicted(const uint256& hashBlock, int conflicting_height, const uint256& hashTx);
 
@@ -716,7 +728,7 @@ public:
      * Main wallet lock.
      * This lock protects all the fields added by CWallet.
      */
-    mutable RecursiveMutex cs_wallet;
+    mutable RecursiveMutex cs_wallet{"cs_wallet"};
 
     bool fWalletUnlockStaking;
 
@@ -1013,6 +1025,8 @@ public:
     void MarkDirty();
     bool AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose = true);
     bool LoadToWallet(CWalletTx& wtxIn);
+    //! Resolve the blocks of the transactions read by LoadWallet, once the chain is loaded
+    void LoadTxsChainState() EXCLUSIVE_LOCKS_REQUIRED(cs_main, cs_wallet);
     void TransactionAddedToMempool(const CTransactionRef& tx) override;
     void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex) override;
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const uint256& blockHash, int nBlockHeight, int64_t blockTime) override;
@@ -1120,6 +1134,11 @@ public:
     bool GetKeyFromPool(CPubKey& key, const uint8_t& type = HDChain::ChangeType::EXTERNAL);
     int64_t GetOldestKeyPoolTime();
 
+    /** Outputs received by dest in the wallet transactions, nullptr if none */
+    const std::set<COutPoint>* GetOutputsByDestination(const CTxDestination& dest) const;
+    const std::map<CTxDestination, std::set<COutPoint>>& GetOutputsByDestination() const;
+    const std::set<COutPoint>& GetP2CSOutputs() const;
+
     std::set<std::set<CTxDestination> > GetAddressGroupings();
     std::map<CTxDestination, CAmount> GetAddressBalances();
 
@@ -1186,6 +1205,13 @@ public:
     /* Mark a transaction (and it in-wallet descendants) as abandoned so its inputs may be respent. */
     bool AbandonTransaction(const uint256& hashTx);
 
+    /* Reads the wallet database, which does not need the chain. Returns a new CWallet instance or a null pointer in case of an error.
+     * fZap zaps the transactions first (-zapwallettxes), returning them in vWtx so that AttachChain restores their metadata */
+    static CWallet* LoadWalletFromFile(const std::string& name, const fs::path& path, bool fZap, bool& fFirstRun, std::vector<CWalletTx>& vWtx);
+
+    /* Attaches a wallet read by LoadWalletFromFile to the loaded chain, rescanning the blocks it missed */
+    bool AttachChain(bool fFirstRun, const std::vector<CWalletTx>& vWtx);
+
     /* Initializes the wallet, returns a new CWallet instance or a null pointer in case of an error */
     static CWallet* CreateWalletFromFile(const std::string& name, const fs::path& path);
 
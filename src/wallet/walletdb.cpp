@@ -15,6 +15,7 @@
 #include "sapling/key_io_sapling.h"
 #include "serialize.h"
 #include "sync.h"
+#include "util/parallel.h"
 #include "util/system.h"
 #include "utiltime.h"
 #include "wallet/wallet.h"
@@ -347,6 +348,45 @@ public:
     }
 };
 
+/** Decode a tx record, ssKey being past the record type. Does not touch the wallet, so it can run on any thread */
+static bool ReadTxRecord(CDataStream& ssKey, CDataStream& ssValue, CWalletTx& wtx, bool& fUpgraded, std::string& strErr)
+{
+    uint256 hash;
+    ssKey >> hash;
+    ssValue >> wtx;
+    if (wtx.GetHash() != hash)
+        return false;
+
+    // Undo serialize changes in 31600
+    if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703) {
+        if (!ssValue.empty()) {
+            char fTmp;
+            char fUnused;
+            std::string unused_string;
+            ssValue >> fTmp >> fUnused >> unused_string;
+            strErr = strprintf("LoadWallet() upgrading tx ver=%d %d %s",
+                wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
+            wtx.fTimeReceivedIsTxTime = fTmp;
+        } else {
+            strErr = strprintf("LoadWallet() repairing tx ver=%d %s", wtx.fTimeReceivedIsTxTime, hash.ToString());
+            wtx.fTimeReceivedIsTxTime = 0;
+        }
+        fUpgraded = true;
+    }
+    return true;
+}
+
+static void LoadTxRecord(CWallet* pwallet, CWalletTx& wtx, bool fUpgraded, CWalletScanState& wss)
+{
+    if (fUpgraded)
+        wss.vWalletUpgrade.push_back(wtx.GetHash());
+
+    if (wtx.nOrderPos == -1)
+        wss.fAnyUnordered = true;
+
+    pwallet->LoadToWallet(wtx);
+}
+
 bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CWalletScanState& wss, std::string& strType, std::string& strErr)
 {
     try {
@@ -367,34 +407,11 @@ bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CW
             ssValue >> strPurpose;
             pwallet->LoadAddressBookPurpose(Standard::DecodeDestination(strAddress), strPurpose);
         } else if (strType == DBKeys::TX) {
-            uint256 hash;
-            ssKey >> hash;
             CWalletTx wtx(nullptr /* pwallet */, MakeTransactionRef());
-            ssValue >> wtx;
-            if (wtx.GetHash() != hash)
+            bool fUpgraded = false;
+            if (!ReadTxRecord(ssKey, ssValue, wtx, fUpgraded, strErr))
                 return false;
-
-            // Undo serialize changes in 31600
-            if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703) {
-                if (!ssValue.empty()) {
-                    char fTmp;
-                    char fUnused;
-                    std::string unused_string;
-                    ssValue >> fTmp >> fUnused >> unused_string;
-                    strErr = strprintf("LoadWallet() upgrading tx ver=%d %d %s",
-                        wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = fTmp;
-                } else {
-                    strErr = strprintf("LoadWallet() repairing tx ver=%d %s", wtx.fTimeReceivedIsTxTime, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = 0;
-                }
-                wss.vWalletUpgrade.push_back(hash);
-            }
-
-            if (wtx.nOrderPos == -1)
-                wss.fAnyUnordered = true;
-
-            pwallet->LoadToWallet(wtx);
+            LoadTxRecord(pwallet, wtx, fUpgraded, wss);
         } else if (strType == DBKeys::WATCHS) {
             CScript script;
             ssKey >> script;
@@ -621,6 +638,50 @@ bool WalletBatch::IsKeyType(const std::string& strType)
             strType == DBKeys::SAP_KEY || strType == DBKeys::SAP_KEY_CRIPTED);
 }
 
+static bool IsTxRecord(const CDataStream& ssKey)
+{
+    CDataStream ssType(ssKey);
+    std::string strType;
+    try {
+        ssType >> strType;
+    } catch (...) {
+        return false;
+    }
+    return strType == DBKeys::TX;
+}
+
+// Below this many tx records a range is not worth handing to a worker
+static const size_t MIN_TX_RECORDS_PER_THREAD = 64;
+
+struct DecodedTxRecord
+{
+    CWalletTx wtx{nullptr /* pwallet */, MakeTransactionRef()};
+    bool fOk{false};
+    bool fUpgraded{false};
+    std::string strErr;
+};
+
+/** Decode the tx records (deserialization and txid hashing) on the shared worker pool */
+static std::vector<DecodedTxRecord> DecodeTxRecords(std::vector<std::pair<CDataStream, CDataStream>>& vRecords)
+{
+    std::vector<DecodedTxRecord> vDecoded(vRecords.size());
+    auto decodeRange = [&vRecords, &vDecoded](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            DecodedTxRecord& rec = vDecoded[i];
+            try {
+                std::string strType;
+                vRecords[i].first >> strType;
+                rec.fOk = ReadTxRecord(vRecords[i].first, vRecords[i].second, rec.wtx, rec.fUpgraded, rec.strErr);
+            } catch (...) {
+                rec.fOk = false;
+            }
+        }
+    };
+
+    ParallelForRanges(vRecords.size(), MIN_TX_RECORDS_PER_THREAD, decodeRange);
+    return vDecoded;
+}
+
 DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
 {
     CWalletScanState wss;
@@ -644,6 +705,9 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
             return DB_CORRUPT;
         }
 
+        // The tx records, the bulk of a busy wallet, are decoded in parallel once
+        // the cursor is done, the other records as they are read
+        std::vector<std::pair<CDataStream, CDataStream>> vTxRecords;
         while (true) {
             // Read next record
             CDataStream ssKey(SER_DISK, CLIENT_VERSION);
@@ -656,6 +720,11 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
                 return DB_CORRUPT;
             }
 
+            if (IsTxRecord(ssKey)) {
+                vTxRecords.emplace_back(std::move(ssKey), std::move(ssValue));
+                continue;
+            }
+
             // Try to be tolerant of single corrupt records:
             std::string strType, strErr;
             if (!ReadKeyValue(pwallet, ssKey, ssValue, wss, strType, strErr)) {
@@ -675,6 +744,22 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
                 LogPrintf("%s\n", strErr);
         }
         pcursor->close();
+
+        // Load the transactions in the database order
+        std::vector<DecodedTxRecord> vDecoded = DecodeTxRecords(vTxRecords);
+        vTxRecords.clear();
+        for (DecodedTxRecord& rec : vDecoded) {
+            if (rec.fOk) {
+                LoadTxRecord(pwallet, rec.wtx, rec.fUpgraded, wss);
+            } else {
+                fNoncriticalErrors = true;
+                // Rescan if there is a bad transaction record:
+                gArgs.SoftSetBoolArg("-rescan", true);
+            }
+            if (!rec.strErr.empty())
+                LogPrintf("%s\n", rec.strErr);
+        }
+        LogPrintf("%s: %u transactions loaded\n", __func__, vDecoded.size());
     } catch (const boost::thread_interrupted&) {
         throw;
     } catch (...) {
@@ -45,6 +45,8 @@ class uint256;
 
 /** Backend-agnostic database type. */
 using WalletDatabase = BerkeleyDatabase;
+/** Group commit of the wallet writes, see BerkeleyDatabase::BeginWriteGroup */
+using WalletWriteGroup = BerkeleyWriteGroup;
 
 /** Error statuses for the wallet database */
 enum DBErrors {
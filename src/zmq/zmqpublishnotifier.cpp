@@ -8,6 +8,9 @@
 #include "util/system.h"
 #include "crypto/common.h"
 #include "validation.h"     // cs_main
+#include "validationtrace.h"
+
+#include <univalue.h>
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
@@ -15,6 +18,7 @@ static const char *MSG_HASHBLOCK  = "hashblock";
 static const char *MSG_HASHTX     = "hashtx";
 static const char *MSG_RAWBLOCK   = "rawblock";
 static const char *MSG_RAWTX      = "rawtx";
+static const char *MSG_BLOCKTRACE = "blocktrace";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -190,3 +194,10 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     ss << transaction;
     return SendMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
 }
+
+bool CZMQPublishBlockTraceNotifier::NotifyBlockTrace(const BlockValidationTrace &trace)
+{
+    LogPrint(BCLog::ZMQ, "Publish blocktrace %s\n", trace.hashBlock.GetHex());
+    const std::string json = trace.ToJSON().write();
+    return SendMessage(MSG_BLOCKTRACE, json.data(), json.size());
+}
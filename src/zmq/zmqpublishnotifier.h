@@ -52,4 +52,10 @@ public:
     bool NotifyTransaction(const CTransaction &transaction);
 };
 
+class CZMQPublishBlockTraceNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBlockTrace(const BlockValidationTrace &trace);
+};
+
 #endif // BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H